@@ -0,0 +1,804 @@
+#include <benchmark/benchmark.h>
+#include <fmt/format.h>
+
+#include <charconv>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <smallstring/arena.hpp>
+#include <smallstring/bulk.hpp>
+#include <smallstring/format.hpp>
+#include <smallstring/hashed.hpp>
+#include <smallstring/huge_page.hpp>
+#include <smallstring/intern.hpp>
+#include <smallstring/json.hpp>
+#include <smallstring/json_reader.hpp>
+#include <smallstring/parallel.hpp>
+#include <smallstring/realloc.hpp>
+#include <smallstring/smallstring.hpp>
+
+namespace {
+
+constexpr int pushes_per_iteration = 100;
+
+/// A value of type @p T with @p digits decimal digits (7...7).
+template <typename T> T value_with_digits(int digits) {
+    T value = 0;
+    for (int i = 0; i < digits; i++)
+        value = static_cast<T>(value * 10 + 7);
+    return value;
+}
+
+/// Run @p push 100 times per iteration into a reused buffer and report
+/// bytes/sec.
+template <typename Push>
+void run_pushes(benchmark::State& state, Push push) {
+    smallstring::Buffer<> buffer(64 * 1024);
+    for (auto _ : state) {
+        buffer.clear();
+        for (int i = 0; i < pushes_per_iteration; i++)
+            push(buffer);
+        benchmark::DoNotOptimize(buffer.head());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(buffer.length()));
+}
+
+/// The same loop against `std::string`.
+template <typename Append>
+void run_appends(benchmark::State& state, Append append) {
+    std::string str;
+    str.reserve(64 * 1024);
+    for (auto _ : state) {
+        str.clear();
+        for (int i = 0; i < pushes_per_iteration; i++)
+            append(str);
+        benchmark::DoNotOptimize(str.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(str.size()));
+}
+
+/* ------------------------------------------------------------------------- */
+/*                              String pushes                                */
+/* ------------------------------------------------------------------------- */
+
+void BM_push_literal(benchmark::State& state) {
+    run_pushes(state, [](auto& buffer) { buffer.push("hello"); });
+}
+BENCHMARK(BM_push_literal);
+
+void BM_string_append_literal(benchmark::State& state) {
+    run_appends(state, [](std::string& str) { str.append("hello"); });
+}
+BENCHMARK(BM_string_append_literal);
+
+void BM_push_string_view(benchmark::State& state) {
+    const std::string source(static_cast<std::size_t>(state.range(0)), 'x');
+    const std::string_view view = source;
+    run_pushes(state, [&](auto& buffer) { buffer.push(view); });
+}
+BENCHMARK(BM_push_string_view)->Arg(8)->Arg(64)->Arg(512);
+
+void BM_string_append_string_view(benchmark::State& state) {
+    const std::string source(static_cast<std::size_t>(state.range(0)), 'x');
+    const std::string_view view = source;
+    run_appends(state, [&](std::string& str) { str.append(view); });
+}
+BENCHMARK(BM_string_append_string_view)->Arg(8)->Arg(64)->Arg(512);
+
+void BM_push_std_string(benchmark::State& state) {
+    const std::string source = "a std::string value";
+    run_pushes(state, [&](auto& buffer) { buffer.push(source); });
+}
+BENCHMARK(BM_push_std_string);
+
+void BM_push_escaped(benchmark::State& state) {
+    std::string source(static_cast<std::size_t>(state.range(0)), 'x');
+    source[source.size() / 2] = '"';
+    run_pushes(state, [&](auto& buffer) { buffer.push_escaped(source); });
+}
+BENCHMARK(BM_push_escaped)->Arg(16)->Arg(256);
+
+void BM_push_hex(benchmark::State& state) {
+    const std::string source(static_cast<std::size_t>(state.range(0)), '\xa5');
+    run_pushes(state, [&](auto& buffer) { buffer.push_hex(source); });
+}
+BENCHMARK(BM_push_hex)->Arg(32);
+
+void BM_push_base64(benchmark::State& state) {
+    const std::string source(static_cast<std::size_t>(state.range(0)), '\xa5');
+    run_pushes(state, [&](auto& buffer) { buffer.push_base64(source); });
+}
+BENCHMARK(BM_push_base64)->Arg(48)->Arg(480);
+
+/* ------------------------------------------------------------------------- */
+/*                             Integer pushes                                */
+/* ------------------------------------------------------------------------- */
+
+template <typename T> void BM_push_integer(benchmark::State& state) {
+    const T value = value_with_digits<T>(static_cast<int>(state.range(0)));
+    run_pushes(state, [&](auto& buffer) { buffer.push(value); });
+}
+
+template <typename T> void BM_to_chars_integer(benchmark::State& state) {
+    const T value = value_with_digits<T>(static_cast<int>(state.range(0)));
+    run_pushes(state, [&](auto& buffer) {
+        char tmp[24];
+        const auto result = std::to_chars(tmp, tmp + sizeof(tmp), value);
+        buffer.push(tmp, static_cast<std::size_t>(result.ptr - tmp));
+    });
+}
+
+template <typename T> void BM_fmt_integer(benchmark::State& state) {
+    const T value = value_with_digits<T>(static_cast<int>(state.range(0)));
+    fmt::memory_buffer out;
+    out.reserve(64 * 1024);
+    for (auto _ : state) {
+        out.clear();
+        for (int i = 0; i < pushes_per_iteration; i++)
+            fmt::format_to(std::back_inserter(out), "{}", value);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(out.size()));
+}
+
+#define SMALLSTRING_INTEGER_BENCHMARKS(T)                                      \
+    BENCHMARK_TEMPLATE(BM_push_integer, T)                                     \
+        ->DenseRange(1, std::numeric_limits<T>::digits10, 4);                  \
+    BENCHMARK_TEMPLATE(BM_to_chars_integer, T)                                 \
+        ->DenseRange(1, std::numeric_limits<T>::digits10, 4);                  \
+    BENCHMARK_TEMPLATE(BM_fmt_integer, T)                                      \
+        ->DenseRange(1, std::numeric_limits<T>::digits10, 4)
+
+SMALLSTRING_INTEGER_BENCHMARKS(std::int32_t);
+SMALLSTRING_INTEGER_BENCHMARKS(std::int64_t);
+SMALLSTRING_INTEGER_BENCHMARKS(std::uint64_t);
+
+void BM_push_padded(benchmark::State& state) {
+    std::uint64_t id = 123456;
+    run_pushes(state, [&](auto& buffer) { buffer.push_padded(id++, 20); });
+}
+BENCHMARK(BM_push_padded);
+
+/* ------------------------------------------------------------------------- */
+/*                          Floating-point pushes                            */
+/* ------------------------------------------------------------------------- */
+
+const double floating_values[] = {0.5, 101.2575, 1.0 / 3.0, 6.02214076e23};
+
+void BM_push_double(benchmark::State& state) {
+    const double value = floating_values[state.range(0)];
+    run_pushes(state, [&](auto& buffer) { buffer.push(value); });
+}
+BENCHMARK(BM_push_double)->DenseRange(0, 3);
+
+void BM_to_chars_double(benchmark::State& state) {
+    const double value = floating_values[state.range(0)];
+    run_pushes(state, [&](auto& buffer) {
+        char tmp[32];
+        const auto result = std::to_chars(tmp, tmp + sizeof(tmp), value);
+        buffer.push(tmp, static_cast<std::size_t>(result.ptr - tmp));
+    });
+}
+BENCHMARK(BM_to_chars_double)->DenseRange(0, 3);
+
+void BM_fmt_double(benchmark::State& state) {
+    const double value = floating_values[state.range(0)];
+    fmt::memory_buffer out;
+    out.reserve(64 * 1024);
+    for (auto _ : state) {
+        out.clear();
+        for (int i = 0; i < pushes_per_iteration; i++)
+            fmt::format_to(std::back_inserter(out), "{}", value);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(out.size()));
+}
+BENCHMARK(BM_fmt_double)->DenseRange(0, 3);
+
+void BM_push_float(benchmark::State& state) {
+    const float value = static_cast<float>(floating_values[state.range(0)]);
+    run_pushes(state, [&](auto& buffer) { buffer.push(value); });
+}
+BENCHMARK(BM_push_float)->DenseRange(0, 3);
+
+void BM_push_fixed(benchmark::State& state) {
+    const double value = floating_values[state.range(0)];
+    run_pushes(state, [&](auto& buffer) { buffer.push_fixed(value, 4); });
+}
+BENCHMARK(BM_push_fixed)->DenseRange(0, 3);
+
+void BM_to_chars_fixed(benchmark::State& state) {
+    const double value = floating_values[state.range(0)];
+    run_pushes(state, [&](auto& buffer) {
+        char tmp[64];
+        const auto result = std::to_chars(tmp, tmp + sizeof(tmp), value,
+                                          std::chars_format::fixed, 4);
+        buffer.push(tmp, static_cast<std::size_t>(result.ptr - tmp));
+    });
+}
+BENCHMARK(BM_to_chars_fixed)->DenseRange(0, 3);
+
+/* ------------------------------------------------------------------------- */
+/*                                 Growth                                    */
+/* ------------------------------------------------------------------------- */
+
+/// Start small and grow to range(0) bytes, 64 bytes at a time.
+template <typename BufferType> void BM_growth(benchmark::State& state) {
+    const std::size_t target = static_cast<std::size_t>(state.range(0));
+    const std::string chunk(64, 'g');
+    for (auto _ : state) {
+        BufferType buffer(16);
+        while (buffer.length() < target)
+            buffer.push(chunk);
+        benchmark::DoNotOptimize(buffer.head());
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(target));
+}
+BENCHMARK_TEMPLATE(BM_growth, smallstring::Buffer<>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_growth, smallstring::InlineBuffer<256>)
+    ->Range(1 << 10, 1 << 20);
+
+// Large buffers: copying on every doubling vs realloc / remapping pages.
+BENCHMARK_TEMPLATE(BM_growth, smallstring::Buffer<>)
+    ->RangeMultiplier(4)
+    ->Range(4 << 20, 64 << 20);
+BENCHMARK_TEMPLATE(BM_growth, smallstring::ReallocBuffer<>)
+    ->RangeMultiplier(4)
+    ->Range(4 << 20, 64 << 20);
+#if defined(__linux__)
+BENCHMARK_TEMPLATE(BM_growth, smallstring::HugePageBuffer<>)
+    ->RangeMultiplier(4)
+    ->Range(4 << 20, 64 << 20);
+#endif
+
+void BM_string_growth(benchmark::State& state) {
+    const std::size_t target = static_cast<std::size_t>(state.range(0));
+    const std::string chunk(64, 'g');
+    for (auto _ : state) {
+        std::string str;
+        while (str.size() < target)
+            str.append(chunk);
+        benchmark::DoNotOptimize(str.data());
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(target));
+}
+BENCHMARK(BM_string_growth)->Range(1 << 10, 1 << 20);
+
+/// Short-lived per-message buffers: heap vs. an arena reset per batch.
+void BM_per_message_heap(benchmark::State& state) {
+    for (auto _ : state) {
+        for (int i = 0; i < pushes_per_iteration; i++) {
+            smallstring::Buffer<> buffer(64);
+            buffer.push("message ");
+            buffer.push(i);
+            benchmark::DoNotOptimize(buffer.head());
+        }
+    }
+}
+BENCHMARK(BM_per_message_heap);
+
+void BM_per_message_arena(benchmark::State& state) {
+    using ArenaBuffer = smallstring::Buffer<smallstring::ArenaAllocator<char>>;
+    smallstring::Arena arena;
+    for (auto _ : state) {
+        for (int i = 0; i < pushes_per_iteration; i++) {
+            ArenaBuffer buffer(64, arena);
+            buffer.push("message ");
+            buffer.push(i);
+            benchmark::DoNotOptimize(buffer.head());
+        }
+        arena.reset();
+    }
+}
+BENCHMARK(BM_per_message_arena);
+
+/* ------------------------------------------------------------------------- */
+/*                                   Pop                                     */
+/* ------------------------------------------------------------------------- */
+
+/// Produce newline-framed records and consume them one at a time.
+void BM_pop_framed(benchmark::State& state) {
+    smallstring::Buffer<> buffer(4096);
+    std::int64_t bytes = 0;
+    for (auto _ : state) {
+        for (int i = 0; i < 32; i++) {
+            buffer.push("{\"seq\":");
+            buffer.push(i);
+            buffer.push("}\n");
+        }
+        bytes += static_cast<std::int64_t>(buffer.length());
+        for (std::size_t at; (at = buffer.find_byte('\n')) !=
+                             std::string_view::npos;)
+            buffer.pop(at + 1);
+        benchmark::DoNotOptimize(buffer.head());
+    }
+    state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_pop_framed);
+
+void BM_string_erase_framed(benchmark::State& state) {
+    std::string str;
+    str.reserve(4096);
+    std::int64_t bytes = 0;
+    for (auto _ : state) {
+        for (int i = 0; i < 32; i++) {
+            str.append("{\"seq\":");
+            str.append(std::to_string(i));
+            str.append("}\n");
+        }
+        bytes += static_cast<std::int64_t>(str.size());
+        for (std::size_t at; (at = str.find('\n')) != std::string::npos;)
+            str.erase(0, at + 1);
+        benchmark::DoNotOptimize(str.data());
+    }
+    state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_string_erase_framed);
+
+/// Partial writes: pop a fixed chunk while more keeps arriving.
+void BM_pop_partial(benchmark::State& state) {
+    smallstring::Buffer<> buffer(64 * 1024);
+    const std::string chunk(1000, 'p');
+    for (auto _ : state) {
+        buffer.push(chunk);
+        buffer.pop(static_cast<std::size_t>(state.range(0)));
+        benchmark::DoNotOptimize(buffer.head());
+    }
+    state.SetBytesProcessed(state.iterations() * 1000);
+}
+BENCHMARK(BM_pop_partial)->Arg(700)->Arg(1000);
+
+/* ------------------------------------------------------------------------- */
+/*                                  Find                                    */
+/* ------------------------------------------------------------------------- */
+
+/// About 4 MiB of newline-framed JSON records with variable payloads.
+const smallstring::Buffer<>& records() {
+    static const smallstring::Buffer<> buffer = [] {
+        const std::string filler(512, 'x');
+        smallstring::Buffer<> out;
+        for (int i = 0; out.length() < (4 << 20); i++) {
+            out.push("{\"seq\":");
+            out.push(i);
+            out.push(",\"payload\":\"");
+            out.push(std::string_view(filler).substr(0, i % 509));
+            out.push("\"}\r\n");
+        }
+        return out;
+    }();
+    return buffer;
+}
+
+template <typename Find> void run_scan(benchmark::State& state, Find find) {
+    const std::string_view text = records().view();
+    for (auto _ : state) {
+        std::size_t count = 0;
+        for (std::size_t pos = find(0); pos != std::string_view::npos;
+             pos = find(pos + 1))
+            count++;
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(text.size()));
+}
+
+void BM_find_byte(benchmark::State& state) {
+    run_scan(state, [](std::size_t pos) {
+        return records().find_byte('\n', pos);
+    });
+}
+BENCHMARK(BM_find_byte);
+
+void BM_string_view_find_byte(benchmark::State& state) {
+    run_scan(state, [](std::size_t pos) {
+        return records().view().find('\n', pos);
+    });
+}
+BENCHMARK(BM_string_view_find_byte);
+
+void BM_find_substring(benchmark::State& state) {
+    run_scan(state, [](std::size_t pos) {
+        return records().find("}\r\n", pos);
+    });
+}
+BENCHMARK(BM_find_substring);
+
+void BM_string_view_find_substring(benchmark::State& state) {
+    run_scan(state, [](std::size_t pos) {
+        return records().view().find("}\r\n", pos);
+    });
+}
+BENCHMARK(BM_string_view_find_substring);
+
+void BM_find_any_of(benchmark::State& state) {
+    static const smallstring::ByteSet delimiters(",:}");
+    run_scan(state, [](std::size_t pos) {
+        return records().find_any_of(delimiters, pos);
+    });
+}
+BENCHMARK(BM_find_any_of);
+
+void BM_string_view_find_first_of(benchmark::State& state) {
+    run_scan(state, [](std::size_t pos) {
+        return records().view().find_first_of(",:}", pos);
+    });
+}
+BENCHMARK(BM_string_view_find_first_of);
+
+/* ------------------------------------------------------------------------- */
+/*                              JSON messages                                */
+/* ------------------------------------------------------------------------- */
+
+struct Quote {
+    std::uint64_t id;
+    const char* symbol;
+    double px;
+    std::int64_t qty;
+    bool is_bid;
+};
+
+const Quote quote = {8675309, "AAPL", 187.25, 300, true};
+
+void BM_json_writer(benchmark::State& state) {
+    run_pushes(state, [](auto& buffer) {
+        smallstring::JsonWriter json(buffer);
+        json.begin_object();
+        json.key("id");
+        json.value(quote.id);
+        json.key("sym");
+        json.value(quote.symbol);
+        json.key("px");
+        json.value_fixed(quote.px, 2);
+        json.key("qty");
+        json.value(quote.qty);
+        json.key("bid");
+        json.value(quote.is_bid);
+        json.end_object();
+    });
+}
+BENCHMARK(BM_json_writer);
+
+void BM_json_format_pattern(benchmark::State& state) {
+    run_pushes(state, [](auto& buffer) {
+        SMALLSTRING_FORMAT(buffer,
+                           "{\"id\":{},\"sym\":\"{}\",\"px\":{},"
+                           "\"qty\":{},\"bid\":{}}",
+                           quote.id, quote.symbol, quote.px, quote.qty,
+                           quote.is_bid ? "true" : "false");
+    });
+}
+BENCHMARK(BM_json_format_pattern);
+
+void BM_json_fmt(benchmark::State& state) {
+    fmt::memory_buffer out;
+    out.reserve(64 * 1024);
+    for (auto _ : state) {
+        out.clear();
+        for (int i = 0; i < pushes_per_iteration; i++) {
+            fmt::format_to(std::back_inserter(out),
+                           "{{\"id\":{},\"sym\":\"{}\",\"px\":{:.2f},"
+                           "\"qty\":{},\"bid\":{}}}",
+                           quote.id, quote.symbol, quote.px, quote.qty,
+                           quote.is_bid);
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(out.size()));
+}
+BENCHMARK(BM_json_fmt);
+
+void BM_json_std_string(benchmark::State& state) {
+    run_appends(state, [](std::string& str) {
+        char tmp[32];
+        str.append("{\"id\":");
+        str.append(tmp, std::to_chars(tmp, tmp + sizeof(tmp), quote.id).ptr);
+        str.append(",\"sym\":\"");
+        str.append(quote.symbol);
+        str.append("\",\"px\":");
+        str.append(tmp, std::to_chars(tmp, tmp + sizeof(tmp), quote.px,
+                                      std::chars_format::fixed, 2)
+                            .ptr);
+        str.append(",\"qty\":");
+        str.append(tmp, std::to_chars(tmp, tmp + sizeof(tmp), quote.qty).ptr);
+        str.append(",\"bid\":");
+        str.append(quote.is_bid ? "true" : "false");
+        str.append("}");
+    });
+}
+BENCHMARK(BM_json_std_string);
+
+/* ------------------------------------------------------------------------- */
+/*                              Bulk records                                 */
+/* ------------------------------------------------------------------------- */
+
+struct Trade {
+    std::uint64_t id;
+    double px;
+    std::int64_t qty;
+};
+
+struct TradeSerializer {
+    std::size_t max_size(const Trade& trade) const {
+        return 24 + smallstring::max_chars<std::uint64_t> +
+               smallstring::max_fixed_chars(trade.px, 4) +
+               smallstring::max_chars<std::int64_t>;
+    }
+
+    template <class Writer> void write(Writer& w, const Trade& trade) const {
+        w.push_unchecked("{\"id\":");
+        w.push_unchecked(trade.id);
+        w.push_unchecked(",\"px\":");
+        w.push_fixed_unchecked(trade.px, 4);
+        w.push_unchecked(",\"qty\":");
+        w.push_unchecked(trade.qty);
+        w.push_unchecked("}\n");
+    }
+};
+
+const std::vector<Trade>& trades() {
+    static const std::vector<Trade> batch = [] {
+        std::vector<Trade> out;
+        for (std::uint64_t i = 0; i < 10000; i++)
+            out.push_back({900000 + i, 100.0 + static_cast<double>(i) / 16,
+                           static_cast<std::int64_t>(i % 977)});
+        return out;
+    }();
+    return batch;
+}
+
+void BM_records_per_field(benchmark::State& state) {
+    smallstring::Buffer<> buffer(1 << 20);
+    for (auto _ : state) {
+        buffer.clear();
+        for (const Trade& trade : trades()) {
+            buffer.push("{\"id\":");
+            buffer.push(trade.id);
+            buffer.push(",\"px\":");
+            buffer.push_fixed(trade.px, 4);
+            buffer.push(",\"qty\":");
+            buffer.push(trade.qty);
+            buffer.push("}\n");
+        }
+        benchmark::DoNotOptimize(buffer.head());
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(buffer.length()));
+}
+BENCHMARK(BM_records_per_field);
+
+void BM_push_records(benchmark::State& state) {
+    smallstring::Buffer<> buffer(1 << 20);
+    for (auto _ : state) {
+        buffer.clear();
+        buffer.push_records(trades(), TradeSerializer{});
+        benchmark::DoNotOptimize(buffer.head());
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(buffer.length()));
+}
+BENCHMARK(BM_push_records);
+
+void BM_push_records_parallel(benchmark::State& state) {
+    smallstring::Buffer<> buffer(1 << 20);
+    for (auto _ : state) {
+        buffer.clear();
+        smallstring::push_records_parallel(
+            buffer, trades(), TradeSerializer{},
+            static_cast<unsigned>(state.range(0)));
+        benchmark::DoNotOptimize(buffer.head());
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(buffer.length()));
+}
+BENCHMARK(BM_push_records_parallel)->Arg(2)->Arg(4)->UseRealTime();
+
+void BM_parallel_builder(benchmark::State& state) {
+    smallstring::ParallelBuilder<> builder(
+        static_cast<unsigned>(state.range(0)));
+    smallstring::Buffer<> out(1 << 20);
+    const auto& batch = trades();
+    constexpr std::size_t shards = 16;
+    const std::size_t per_shard = batch.size() / shards;
+    for (auto _ : state) {
+        builder.clear();
+        out.clear();
+        builder.build(shards, [&](std::size_t i, smallstring::Buffer<>& b) {
+            b.push_records(batch.data() + i * per_shard, per_shard,
+                           TradeSerializer{});
+        });
+        builder.concatenate(out);
+        benchmark::DoNotOptimize(out.head());
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(out.length()));
+}
+BENCHMARK(BM_parallel_builder)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+
+/* ------------------------------------------------------------------------- */
+/*                                Interning                                  */
+/* ------------------------------------------------------------------------- */
+
+const std::vector<std::string>& symbols() {
+    static const std::vector<std::string> names = [] {
+        std::vector<std::string> out;
+        for (int i = 0; i < 4096; i++)
+            out.push_back("SYM" + std::to_string(i * 7919 % 100003));
+        return out;
+    }();
+    return names;
+}
+
+void BM_intern_find(benchmark::State& state) {
+    smallstring::InternTable<> table;
+    for (const auto& name : symbols())
+        table.intern(name);
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(table.find(symbols()[i]));
+        i = (i + 1) & 4095;
+    }
+}
+BENCHMARK(BM_intern_find);
+
+void BM_unordered_map_find(benchmark::State& state) {
+    std::unordered_map<std::string_view, std::uint32_t> table;
+    for (const auto& name : symbols())
+        table.emplace(name, static_cast<std::uint32_t>(table.size()));
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(table.find(symbols()[i]));
+        i = (i + 1) & 4095;
+    }
+}
+BENCHMARK(BM_unordered_map_find);
+
+void BM_push_interned(benchmark::State& state) {
+    smallstring::InternTable<> table;
+    for (const auto& name : symbols())
+        table.intern(name);
+    smallstring::Buffer<> buffer(1 << 16);
+    for (auto _ : state) {
+        buffer.clear();
+        for (std::uint32_t id = 0; id < 256; id++)
+            buffer.push_interned(table, id);
+        benchmark::DoNotOptimize(buffer.head());
+    }
+}
+BENCHMARK(BM_push_interned);
+
+void BM_push_quoted_escaped(benchmark::State& state) {
+    smallstring::Buffer<> buffer(1 << 16);
+    for (auto _ : state) {
+        buffer.clear();
+        for (std::size_t id = 0; id < 256; id++) {
+            buffer.push("\"");
+            buffer.push_escaped(symbols()[id]);
+            buffer.push("\"");
+        }
+        benchmark::DoNotOptimize(buffer.head());
+    }
+}
+BENCHMARK(BM_push_quoted_escaped);
+
+/* ------------------------------------------------------------------------- */
+/*                             Hashing / equality                            */
+/* ------------------------------------------------------------------------- */
+
+template <class BufferType> void build_snapshot_key(BufferType& buffer) {
+    for (std::uint64_t i = 0; i < 32; i++) {
+        buffer.push("{\"id\":");
+        buffer.push(900000 + i);
+        buffer.push(",\"px\":");
+        buffer.push_fixed(100.0 + static_cast<double>(i) / 8, 3);
+        buffer.push("}");
+    }
+}
+
+void BM_build_then_std_hash(benchmark::State& state) {
+    smallstring::Buffer<> buffer(4096);
+    for (auto _ : state) {
+        buffer.clear();
+        build_snapshot_key(buffer);
+        benchmark::DoNotOptimize(std::hash<std::string_view>{}(buffer.view()));
+    }
+}
+BENCHMARK(BM_build_then_std_hash);
+
+void BM_build_hashed(benchmark::State& state) {
+    smallstring::HashedBuffer<> buffer(4096);
+    for (auto _ : state) {
+        buffer.clear();
+        build_snapshot_key(buffer);
+        benchmark::DoNotOptimize(buffer.hash());
+    }
+}
+BENCHMARK(BM_build_hashed);
+
+void BM_buffer_equal(benchmark::State& state) {
+    smallstring::Buffer<> a(4096), b(4096);
+    build_snapshot_key(a);
+    build_snapshot_key(b);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a == b);
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(a.length()));
+}
+BENCHMARK(BM_buffer_equal);
+
+/* ------------------------------------------------------------------------- */
+
+/// About 64 KiB of NDJSON order messages.
+std::string inbound_stream() {
+    smallstring::Buffer<> buffer(1 << 16);
+    for (int i = 0; buffer.length() < (1 << 16); i++) {
+        buffer.push("{\"type\":\"order\",\"id\":");
+        buffer.push(700000 + i);
+        buffer.push(",\"sym\":\"MSFT\",\"px\":");
+        buffer.push_fixed(410.0 + static_cast<double>(i % 97) / 16, 4);
+        buffer.push(",\"tags\":[\"a\\\"b\",\"ioc\"],\"live\":true}\n");
+    }
+    return std::string(buffer.view());
+}
+
+/// Receive loop: 4 KiB reads, tokenize each complete message, pop it.
+void BM_json_tokenize_stream(benchmark::State& state) {
+    const std::string stream = inbound_stream();
+    smallstring::Buffer<> inbound(1 << 16);
+    smallstring::JsonTokenizer json;
+    for (auto _ : state) {
+        std::size_t tokens = 0;
+        for (std::size_t fed = 0; fed < stream.size(); fed += 4096) {
+            inbound.push(std::string_view(stream).substr(fed, 4096));
+            while (const std::size_t n = json.next(inbound.view())) {
+                tokens += json.tokens().size();
+                inbound.pop(n);
+            }
+        }
+        benchmark::DoNotOptimize(tokens);
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(stream.size()));
+}
+BENCHMARK(BM_json_tokenize_stream);
+
+/// The framing it replaces: find each newline and pop the line.
+void BM_json_frame_newlines(benchmark::State& state) {
+    const std::string stream = inbound_stream();
+    smallstring::Buffer<> inbound(1 << 16);
+    for (auto _ : state) {
+        std::size_t lines = 0;
+        for (std::size_t fed = 0; fed < stream.size(); fed += 4096) {
+            inbound.push(std::string_view(stream).substr(fed, 4096));
+            for (std::size_t at; (at = inbound.find_byte('\n')) !=
+                                 std::string_view::npos;
+                 lines++)
+                inbound.pop(at + 1);
+        }
+        benchmark::DoNotOptimize(lines);
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(stream.size()));
+}
+BENCHMARK(BM_json_frame_newlines);
+
+} // namespace
+
+BENCHMARK_MAIN();
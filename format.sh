@@ -2,5 +2,5 @@
 
 clang-format -i include/smallstring/*.hpp
 clang-format -i example.cpp
-clang-format -i benchmark.cpp
+clang-format -i benchmarks/*.cpp
 clang-format -i tests/*.cpp
\ No newline at end of file
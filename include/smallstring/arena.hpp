@@ -0,0 +1,225 @@
+/**
+ * @file arena.hpp
+ * @brief Bump-pointer arena and an allocator for `Buffer`'s `Alloc` slot.
+ *
+ * Allocation is a pointer bump, deallocation is free (only the most recent
+ * allocation is actually given back), and everything is released at once
+ * with `Arena::reset()` – e.g. once per request or per tick.  A growing
+ * buffer allocates its new block before freeing the old one, so every block
+ * it outgrows stays spent until the reset; size the first block to the
+ * expected message.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib> // std::malloc, std::free
+#include <new>     // std::bad_alloc
+#include <type_traits>
+#include <utility>
+
+namespace smallstring {
+
+/**
+ * @class Arena
+ * @brief Monotonic memory arena: a chain of blocks carved by a bump pointer.
+ *
+ * An arena may start in a caller-supplied block (stack memory, a static
+ * buffer, a slice of a shared-memory segment); further blocks come from
+ * `std::malloc`.  Not thread-safe.
+ */
+class Arena {
+  private:
+    struct Block {
+        Block* next;
+        std::size_t size; ///< Usable bytes following this header
+        char* data() { return reinterpret_cast<char*>(this + 1); }
+    };
+
+    char* m_cursor = nullptr;
+    char* m_limit = nullptr;
+    Block* m_blocks = nullptr; ///< Heap blocks in use, newest first
+    Block* m_spare = nullptr;  ///< Largest block kept across `reset()`
+    char* m_initial = nullptr; ///< Caller-supplied first block
+    std::size_t m_initial_size = 0;
+    std::size_t m_block_size;
+
+    /// @brief Bytes to skip from @p ptr to the next multiple of @p align.
+    static std::size_t padding_for(const char* ptr, std::size_t align) {
+        const auto address = reinterpret_cast<std::uintptr_t>(ptr);
+        return (align - address % align) % align;
+    }
+
+    void use(Block* block) {
+        block->next = m_blocks;
+        m_blocks = block;
+        m_cursor = block->data();
+        m_limit = block->data() + block->size;
+    }
+
+    void* allocate_slow(std::size_t bytes, std::size_t align) {
+        const std::size_t needed = bytes + align;
+        if (m_spare && m_spare->size >= needed) {
+            use(std::exchange(m_spare, nullptr));
+        } else {
+            const std::size_t size =
+                needed > m_block_size ? needed : m_block_size;
+            void* raw = std::malloc(sizeof(Block) + size);
+            if (!raw)
+                throw std::bad_alloc();
+            Block* block = static_cast<Block*>(raw);
+            block->size = size;
+            use(block);
+        }
+        char* ptr = m_cursor + padding_for(m_cursor, align);
+        m_cursor = ptr + bytes;
+        return ptr;
+    }
+
+    static void free_chain(Block* block) {
+        while (block)
+            std::free(std::exchange(block, block->next));
+    }
+
+  public:
+    /// @brief Arena whose blocks are @p block_size bytes (or the request).
+    explicit Arena(std::size_t block_size = 64 * 1024)
+        : m_block_size(block_size) {}
+
+    /// @brief Arena that carves @p buffer first and then falls back to heap
+    ///        blocks of @p block_size.  @p buffer must outlive the arena.
+    Arena(void* buffer, std::size_t size, std::size_t block_size = 64 * 1024)
+        : m_cursor(static_cast<char*>(buffer)),
+          m_limit(static_cast<char*>(buffer) + size),
+          m_initial(static_cast<char*>(buffer)), m_initial_size(size),
+          m_block_size(block_size) {}
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    ~Arena() {
+        free_chain(m_blocks);
+        free_chain(m_spare);
+    }
+
+    /// @brief Carve @p bytes aligned to @p align (a power of two).
+    void* allocate(std::size_t bytes,
+                   std::size_t align = alignof(std::max_align_t)) {
+        if (m_cursor) {
+            // Padding is checked against the space left before it is
+            // applied: near the limit it may not fit at all.
+            const std::size_t padding = padding_for(m_cursor, align);
+            const auto left = static_cast<std::size_t>(m_limit - m_cursor);
+            if (padding <= left && bytes <= left - padding) {
+                char* ptr = m_cursor + padding;
+                m_cursor = ptr + bytes;
+                return ptr;
+            }
+        }
+        return allocate_slow(bytes, align);
+    }
+
+    /// @brief Give back @p ptr if it is the most recent allocation; no-op
+    ///        otherwise.
+    void deallocate(void* ptr, std::size_t bytes) noexcept {
+        if (static_cast<char*>(ptr) + bytes == m_cursor)
+            m_cursor = static_cast<char*>(ptr);
+    }
+
+    /**
+     * @brief Release every allocation at once.
+     *
+     * The caller-supplied block (if any) is reused first; the largest heap
+     * block is kept for the next overflow and the others are freed.
+     */
+    void reset() noexcept {
+        Block* keep = m_spare;
+        for (Block* block = m_blocks; block;) {
+            Block* next = block->next;
+            if (!keep || block->size > keep->size)
+                std::swap(block, keep);
+            std::free(block);
+            block = next;
+        }
+        m_blocks = nullptr;
+        m_spare = keep;
+        if (m_spare)
+            m_spare->next = nullptr;
+        m_cursor = m_initial;
+        m_limit = m_initial + m_initial_size;
+    }
+
+    /// @brief Whether @p ptr points into memory currently held by the arena.
+    bool owns(const void* ptr) const noexcept {
+        const char* p = static_cast<const char*>(ptr);
+        if (m_initial && p >= m_initial && p < m_initial + m_initial_size)
+            return true;
+        for (Block* block = m_blocks; block; block = block->next) {
+            if (p >= block->data() && p < block->data() + block->size)
+                return true;
+        }
+        return false;
+    }
+};
+
+/**
+ * @class ArenaAllocator
+ * @brief STL allocator drawing from an `Arena`; plug it into `Buffer`.
+ *
+ * @code
+ *   smallstring::Arena arena;
+ *   smallstring::Buffer<smallstring::ArenaAllocator<char>> buf(256, arena);
+ *   // ... build the message, send it ...
+ *   arena.reset(); // after every buffer using it is gone
+ * @endcode
+ *
+ * Allocators compare equal iff they share an arena.  Copy and move
+ * assignment do not propagate the arena, so an assigned-to buffer keeps its
+ * bytes in its own arena (the contents are copied when arenas differ).
+ * `Buffer` has no member swap; `std::swap` goes through move construction
+ * and move assignment, so two buffers on different arenas exchange contents
+ * by copying, each staying in its own arena.  Swap propagation is only
+ * used by standard containers with a member swap, such as `std::vector`.
+ */
+template <class T> class ArenaAllocator {
+  private:
+    template <class U> friend class ArenaAllocator;
+    Arena* m_arena;
+
+  public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::false_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    ArenaAllocator(Arena& arena) noexcept : m_arena(&arena) {}
+
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+        : m_arena(other.m_arena) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* ptr, std::size_t n) noexcept {
+        m_arena->deallocate(ptr, n * sizeof(T));
+    }
+
+    /// @brief The arena this allocator draws from.
+    Arena& arena() const noexcept { return *m_arena; }
+
+    template <class U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept {
+        return m_arena == other.m_arena;
+    }
+
+    template <class U>
+    bool operator!=(const ArenaAllocator<U>& other) const noexcept {
+        return m_arena != other.m_arena;
+    }
+};
+
+} // namespace smallstring
@@ -0,0 +1,467 @@
+/**
+ * @file async_sink.hpp
+ * @brief Hand filled buffers to the kernel without waiting for the write.
+ *
+ * `AsyncSink` owns submitted buffers until they have been written, so the
+ * caller can format the next batch while the previous one is still in
+ * flight.  Writes go through io_uring when the kernel allows it, and
+ * through non-blocking `writev` driven by `epoll` otherwise.  Written
+ * buffers go back to their `BufferPool` in completion order.
+ *
+ * Linux only.  io_uring is used through its raw system calls, so there is
+ * nothing to link.
+ */
+
+#pragma once
+
+#if defined(__linux__)
+
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if __has_include(<linux/io_uring.h>) && defined(__NR_io_uring_setup)
+#include <linux/io_uring.h>
+#define SMALLSTRING_HAS_IO_URING 1
+#endif
+
+#include "pool.hpp"
+#include "smallstring.hpp"
+
+namespace smallstring {
+
+namespace detail {
+
+[[noreturn]] inline void sink_fail(int error, const char* what) {
+    throw std::system_error(error, std::generic_category(), what);
+}
+
+#if defined(SMALLSTRING_HAS_IO_URING)
+
+/**
+ * @class IoUring
+ * @brief Just enough of io_uring for one `writev` in flight at a time.
+ */
+class IoUring {
+  private:
+    int m_fd = -1;
+    void* m_sq_ring = MAP_FAILED;
+    std::size_t m_sq_ring_size = 0;
+    void* m_cq_ring = MAP_FAILED;
+    std::size_t m_cq_ring_size = 0;
+    io_uring_sqe* m_sqes = nullptr;
+    std::size_t m_sqes_size = 0;
+
+    unsigned* m_sq_tail = nullptr;
+    unsigned* m_sq_mask = nullptr;
+    unsigned* m_sq_array = nullptr;
+    unsigned* m_cq_head = nullptr;
+    unsigned* m_cq_tail = nullptr;
+    unsigned* m_cq_mask = nullptr;
+    io_uring_cqe* m_cqes = nullptr;
+
+    static int enter(int fd, unsigned submit, unsigned wait, unsigned flags) {
+        return static_cast<int>(syscall(__NR_io_uring_enter, fd, submit, wait,
+                                        flags, nullptr, 0));
+    }
+
+    void close() {
+        if (m_sqes)
+            munmap(m_sqes, m_sqes_size);
+        if (m_cq_ring != MAP_FAILED && m_cq_ring != m_sq_ring)
+            munmap(m_cq_ring, m_cq_ring_size);
+        if (m_sq_ring != MAP_FAILED)
+            munmap(m_sq_ring, m_sq_ring_size);
+        if (m_fd >= 0)
+            ::close(m_fd);
+        m_fd = -1;
+        m_sq_ring = m_cq_ring = MAP_FAILED;
+        m_sqes = nullptr;
+    }
+
+  public:
+    IoUring() = default;
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+    ~IoUring() { close(); }
+
+    /// @brief Set up a small ring; false if io_uring is unavailable here
+    ///        (old kernel, seccomp, `io_uring_disabled`).
+    bool open() {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        m_fd = static_cast<int>(syscall(__NR_io_uring_setup, 4, &params));
+        if (m_fd < 0)
+            return false;
+        // Offset -1 ("current position") keeps files appending in order.
+        if (!(params.features & IORING_FEAT_RW_CUR_POS)) {
+            close();
+            return false;
+        }
+        m_sq_ring_size =
+            params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        m_cq_ring_size =
+            params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single && m_cq_ring_size > m_sq_ring_size)
+            m_sq_ring_size = m_cq_ring_size;
+        m_sq_ring = mmap(nullptr, m_sq_ring_size, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+        if (m_sq_ring == MAP_FAILED) {
+            close();
+            return false;
+        }
+        m_cq_ring = single ? m_sq_ring
+                           : mmap(nullptr, m_cq_ring_size,
+                                  PROT_READ | PROT_WRITE,
+                                  MAP_SHARED | MAP_POPULATE, m_fd,
+                                  IORING_OFF_CQ_RING);
+        m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = m_cq_ring == MAP_FAILED
+                         ? MAP_FAILED
+                         : mmap(nullptr, m_sqes_size, PROT_READ | PROT_WRITE,
+                                MAP_SHARED | MAP_POPULATE, m_fd,
+                                IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) {
+            close();
+            return false;
+        }
+        m_sqes = static_cast<io_uring_sqe*>(sqes);
+
+        char* sq = static_cast<char*>(m_sq_ring);
+        char* cq = static_cast<char*>(m_cq_ring);
+        m_sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        m_sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        m_sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        m_cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        m_cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        m_cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        m_cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    /// @brief Queue and submit `writev(fd, iov, count)` at the current
+    ///        file position.
+    void submit_writev(int fd, const iovec* iov, unsigned count) {
+        const unsigned tail = *m_sq_tail;
+        const unsigned index = tail & *m_sq_mask;
+        io_uring_sqe& sqe = m_sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_WRITEV;
+        sqe.fd = fd;
+        sqe.addr = reinterpret_cast<std::uintptr_t>(iov);
+        sqe.len = count;
+        sqe.off = static_cast<std::uint64_t>(-1);
+        m_sq_array[index] = index;
+        __atomic_store_n(m_sq_tail, tail + 1, __ATOMIC_RELEASE);
+        while (enter(m_fd, 1, 0, 0) < 0)
+            if (errno != EINTR)
+                sink_fail(errno, "io_uring_enter");
+    }
+
+    /// @brief Pop a completion into @p result (bytes written or -errno);
+    ///        false if none is ready and @p wait is false.
+    bool reap(bool wait, int& result) {
+        for (;;) {
+            const unsigned head = *m_cq_head;
+            if (head != __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE)) {
+                result = m_cqes[head & *m_cq_mask].res;
+                __atomic_store_n(m_cq_head, head + 1, __ATOMIC_RELEASE);
+                return true;
+            }
+            if (!wait)
+                return false;
+            if (enter(m_fd, 0, 1, IORING_ENTER_GETEVENTS) < 0 &&
+                errno != EINTR)
+                sink_fail(errno, "io_uring_enter");
+        }
+    }
+};
+
+#endif // SMALLSTRING_HAS_IO_URING
+
+} // namespace detail
+
+/**
+ * @class AsyncSink
+ * @brief Writes submitted buffers to a file descriptor behind the caller's
+ *        back, in submission order.
+ *
+ * @code
+ *   smallstring::BufferPool<> pool(64 * 1024);
+ *   smallstring::AsyncSink<> sink(fd, pool); // double buffered
+ *   for (const auto& batch : batches) {
+ *       auto buf = sink.acquire();          // waits if 2 are in flight
+ *       for (const auto& msg : batch)
+ *           write_message(*buf, msg);
+ *       sink.submit(std::move(buf));        // returns at once
+ *   }
+ *   sink.flush();
+ * @endcode
+ *
+ * At most `depth` buffers are owned by the sink at once: `acquire()` waits
+ * for the oldest write to finish when the sink is full, so with the default
+ * depth of 2 the next batch is formatted while the previous one is being
+ * written (3 gives triple buffering).  Consecutive buffers are coalesced into
+ * one `writev`, and short writes are resumed.
+ *
+ * Backends
+ * * **io_uring** – one `IORING_OP_WRITEV` in flight; progress is collected
+ *   by `poll()`, `acquire()`, `submit()` and `flush()` on the calling thread.
+ * * **epoll** – the descriptor is switched to non-blocking mode for the
+ *   sink's lifetime, and `writev` is retried when `epoll` reports it
+ *   writable.  Regular files cannot be polled and are written with a plain
+ *   `writev` on submit.
+ *
+ * The sink does not close @p fd.  Write errors throw `std::system_error`
+ * from whichever call observes them; the failed buffer stays queued.  Not
+ * thread-safe; @p pool must outlive the sink.
+ */
+template <class BufferType = Buffer<>> class AsyncSink {
+  public:
+    using Pool = BufferPool<BufferType>;
+    using Lease = typename Pool::Lease;
+
+    enum class Backend {
+        automatic, ///< io_uring if available, else epoll
+        io_uring,
+        epoll,
+    };
+
+  private:
+    int m_fd;
+    Pool& m_pool;
+    std::size_t m_depth;
+    std::deque<Lease> m_queue; ///< Submitted, oldest first
+    std::size_t m_front_written = 0; ///< Bytes of the front already written
+    std::vector<iovec> m_iov;        ///< Arguments of the write in flight
+    bool m_busy = false;             ///< An io_uring write is in flight
+    std::size_t m_bytes_written = 0;
+    Backend m_backend = Backend::epoll;
+#if defined(SMALLSTRING_HAS_IO_URING)
+    detail::IoUring m_ring;
+#endif
+    int m_epoll = -1;       ///< -1 for unpollable fds (blocking writes)
+    int m_saved_flags = -1; ///< fd flags to restore, if we changed them
+
+    /// @brief Point `m_iov` at the unwritten part of the queue.
+    void gather() {
+        m_iov.clear();
+        std::size_t skip = m_front_written;
+        for (auto& lease : m_queue) {
+            if (m_iov.size() == IOV_MAX)
+                break;
+            m_iov.push_back({lease->head() + skip, lease->length() - skip});
+            skip = 0;
+        }
+    }
+
+    /// @brief Retire @p n written bytes, releasing finished buffers.
+    void consume(std::size_t n) {
+        m_bytes_written += n;
+        while (n) {
+            const std::size_t rest = m_queue.front()->length() -
+                                     m_front_written;
+            if (n < rest) {
+                m_front_written += n;
+                return;
+            }
+            n -= rest;
+            m_front_written = 0;
+            m_queue.pop_front();
+        }
+    }
+
+    /// @brief Start the next write (io_uring) or write what the fd will
+    ///        take without blocking (epoll).
+    void pump() {
+#if defined(SMALLSTRING_HAS_IO_URING)
+        if (m_backend == Backend::io_uring) {
+            if (!m_busy && !m_queue.empty()) {
+                gather();
+                m_ring.submit_writev(m_fd, m_iov.data(),
+                                     static_cast<unsigned>(m_iov.size()));
+                m_busy = true;
+            }
+            return;
+        }
+#endif
+        while (!m_queue.empty()) {
+            gather();
+            const ssize_t n =
+                ::writev(m_fd, m_iov.data(), static_cast<int>(m_iov.size()));
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                    return;
+                detail::sink_fail(errno, "writev");
+            }
+            consume(static_cast<std::size_t>(n));
+        }
+    }
+
+    /// @brief Collect finished writes and start new ones; with @p wait,
+    ///        block until at least one write has made progress.
+    void progress(bool wait) {
+#if defined(SMALLSTRING_HAS_IO_URING)
+        if (m_backend == Backend::io_uring) {
+            pump();
+            int result;
+            while (m_busy && m_ring.reap(wait, result)) {
+                m_busy = false;
+                if (result == -EINTR || result == -EAGAIN) {
+                    pump();
+                    continue;
+                }
+                wait = false;
+                if (result < 0)
+                    detail::sink_fail(-result, "AsyncSink: write");
+                consume(static_cast<std::size_t>(result));
+                pump();
+            }
+            return;
+        }
+#endif
+        pump();
+        if (wait && !m_queue.empty() && m_epoll >= 0) {
+            epoll_event event;
+            while (epoll_wait(m_epoll, &event, 1, -1) < 0)
+                if (errno != EINTR)
+                    detail::sink_fail(errno, "epoll_wait");
+            pump();
+        }
+    }
+
+    void open_epoll() {
+        m_backend = Backend::epoll;
+        const int flags = fcntl(m_fd, F_GETFL);
+        if (flags < 0)
+            detail::sink_fail(errno, "fcntl");
+        m_epoll = epoll_create1(EPOLL_CLOEXEC);
+        if (m_epoll < 0)
+            detail::sink_fail(errno, "epoll_create1");
+        epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = EPOLLOUT;
+        if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_fd, &event) != 0) {
+            // Regular files are always "ready"; write them directly.
+            const int error = errno;
+            ::close(std::exchange(m_epoll, -1));
+            if (error != EPERM)
+                detail::sink_fail(error, "epoll_ctl");
+            return;
+        }
+        if (!(flags & O_NONBLOCK)) {
+            if (fcntl(m_fd, F_SETFL, flags | O_NONBLOCK) != 0)
+                detail::sink_fail(errno, "fcntl");
+            m_saved_flags = flags;
+        }
+    }
+
+  public:
+    /**
+     * @param fd      Descriptor to write to (file, pipe or stream socket).
+     * @param pool    Pool that `acquire()` leases from.
+     * @param depth   Buffers the sink holds before `acquire()` waits.
+     * @param backend `Backend::io_uring` falls back to epoll if io_uring
+     *                cannot be set up.
+     *
+     * @throws std::system_error if the epoll backend cannot be set up.
+     */
+    AsyncSink(int fd, Pool& pool, std::size_t depth = 2,
+              Backend backend = Backend::automatic)
+        : m_fd(fd), m_pool(pool), m_depth(depth ? depth : 1) {
+#if defined(SMALLSTRING_HAS_IO_URING)
+        if (backend != Backend::epoll && m_ring.open()) {
+            m_backend = Backend::io_uring;
+            return;
+        }
+#endif
+        (void)backend;
+        open_epoll();
+    }
+
+    AsyncSink(const AsyncSink&) = delete;
+    AsyncSink& operator=(const AsyncSink&) = delete;
+
+    /// @brief Waits for everything submitted to be written (errors are
+    ///        swallowed; call `flush()` first to see them).
+    ~AsyncSink() {
+        try {
+            flush();
+        } catch (...) {
+        }
+#if defined(SMALLSTRING_HAS_IO_URING)
+        // The kernel may still be reading the buffers.
+        int result;
+        while (m_busy && m_ring.reap(true, result))
+            m_busy = false;
+#endif
+        if (m_saved_flags >= 0)
+            fcntl(m_fd, F_SETFL, m_saved_flags);
+        if (m_epoll >= 0)
+            ::close(m_epoll);
+    }
+
+    /// @brief The backend actually in use.
+    Backend backend() const { return m_backend; }
+
+    /// @brief A buffer to fill, waiting first while `depth` are in flight.
+    Lease acquire() {
+        progress(false);
+        while (m_queue.size() >= m_depth)
+            progress(true);
+        return m_pool.acquire();
+    }
+
+    /// @brief Queue @p buffer for writing; it returns to the pool once
+    ///        written.  Empty buffers are released at once.
+    void submit(Lease&& buffer) {
+        if (buffer->length() == 0) {
+            buffer.reset();
+            return;
+        }
+        m_queue.push_back(std::move(buffer));
+        progress(false);
+    }
+
+    /// @brief Queue a buffer that did not come from the pool; it joins the
+    ///        pool once written.
+    void submit(BufferType&& buffer) {
+        submit(m_pool.adopt(std::move(buffer)));
+    }
+
+    /// @brief Collect finished writes and start pending ones; never blocks.
+    void poll() { progress(false); }
+
+    /// @brief Block until every submitted byte has been written.
+    void flush() {
+        progress(false);
+        while (!m_queue.empty())
+            progress(true);
+    }
+
+    /// @brief Buffers submitted but not yet fully written.
+    std::size_t pending() const { return m_queue.size(); }
+
+    /// @brief Bytes written since construction.
+    std::size_t bytes_written() const { return m_bytes_written; }
+};
+
+} // namespace smallstring
+
+#endif // __linux__
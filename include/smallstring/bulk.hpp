@@ -0,0 +1,141 @@
+/**
+ * @file bulk.hpp
+ * @brief Helpers for `push_records`: per-field size bounds and a variant
+ *        that splits the batch across threads.
+ *
+ * @code
+ *   struct TradeSerializer {
+ *       std::size_t max_size(const Trade& t) const {
+ *           return 32 + smallstring::max_chars<std::uint64_t> +
+ *                  smallstring::max_fixed_chars(t.px, 4) +
+ *                  smallstring::max_chars<std::int64_t>;
+ *       }
+ *       template <class Writer> void write(Writer& w, const Trade& t) const {
+ *           w.push_unchecked("{\"id\":");
+ *           w.push_unchecked(t.id);
+ *           w.push_unchecked(",\"px\":");
+ *           w.push_fixed_unchecked(t.px, 4);
+ *           w.push_unchecked(",\"qty\":");
+ *           w.push_unchecked(t.qty);
+ *           w.push_unchecked("}\n");
+ *       }
+ *   };
+ *   buf.push_records(trades, TradeSerializer{});
+ *   smallstring::push_records_parallel(buf, trades, TradeSerializer{});
+ * @endcode
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "smallstring.hpp"
+
+namespace smallstring {
+
+/// @brief Upper bound on `push_unchecked(T)` output for an arithmetic @p T.
+template <typename T>
+inline constexpr std::size_t max_chars = [] {
+    static_assert(std::is_arithmetic<T>::value, "max_chars needs a number");
+    if constexpr (std::is_integral<T>::value)
+        return detail::max_integer_chars<T>;
+    else if constexpr (std::is_same<T, float>::value)
+        return detail::max_shortest_chars<float>;
+    else
+        return detail::max_shortest_chars<double>;
+}();
+
+/// @brief Upper bound on `push_fixed_unchecked(value, precision)` output.
+inline std::size_t max_fixed_chars(double value, std::size_t precision) {
+    return detail::max_fixed_chars(value, precision);
+}
+
+/// @brief Upper bound on `push_escaped_unchecked` output for @p length
+///        input bytes.
+constexpr std::size_t max_escaped_chars(std::size_t length) {
+    return length * detail::max_json_escape_chars;
+}
+
+/**
+ * @brief `out.push_records(records, count, serializer)`, split across up to
+ *        @p threads threads.
+ *
+ * Each thread serialises a contiguous chunk (of at least @p min_chunk
+ * records) into its own `Buffer<>`; the chunks are then appended to @p out
+ * in order with a single reservation.  @p serializer is shared between the
+ * threads and must be safe to call concurrently.  Small batches run on the
+ * calling thread, as do chunks whose thread could not be started.
+ *
+ * If serialising any chunk throws, every thread is still joined and the
+ * exception of the lowest such chunk is rethrown; @p out is left as it was.
+ */
+template <class BufferType, class T, class Serializer>
+void push_records_parallel(BufferType& out, const T* records,
+                           std::size_t count, const Serializer& serializer,
+                           unsigned threads = 0, std::size_t min_chunk = 1024) {
+    if (threads == 0)
+        threads = std::thread::hardware_concurrency();
+    std::size_t chunks = min_chunk ? (count + min_chunk - 1) / min_chunk : 1;
+    chunks = chunks < threads ? chunks : threads;
+    if (chunks <= 1) {
+        out.push_records(records, count, serializer);
+        return;
+    }
+
+    const std::size_t per_chunk = (count + chunks - 1) / chunks;
+    std::vector<Buffer<>> parts(chunks, Buffer<>(0));
+    std::vector<std::exception_ptr> errors(chunks);
+    const auto build = [&](std::size_t chunk) noexcept {
+        const std::size_t first = chunk * per_chunk;
+        const std::size_t last =
+            first + per_chunk < count ? first + per_chunk : count;
+        try {
+            if (first < last)
+                parts[chunk].push_records(records + first, last - first,
+                                          serializer);
+        } catch (...) {
+            errors[chunk] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> workers;
+    workers.reserve(chunks - 1);
+    std::size_t spawned = 1;
+    try {
+        for (; spawned < chunks; spawned++)
+            workers.emplace_back(build, spawned);
+    } catch (const std::system_error&) {
+        // Out of threads: the remaining chunks run here instead.
+    }
+    build(0);
+    for (std::size_t chunk = spawned; chunk < chunks; chunk++)
+        build(chunk);
+    for (auto& worker : workers)
+        worker.join();
+    for (const auto& error : errors)
+        if (error)
+            std::rethrow_exception(error);
+
+    std::size_t total = 0;
+    for (const auto& part : parts)
+        total += part.length();
+    out.ensure_fit(total);
+    for (const auto& part : parts)
+        out.push(part.view());
+}
+
+/// @brief `push_records_parallel` over a contiguous container.
+template <class BufferType, class Container, class Serializer>
+void push_records_parallel(BufferType& out, const Container& records,
+                           const Serializer& serializer, unsigned threads = 0,
+                           std::size_t min_chunk = 1024) {
+    push_records_parallel(out, std::data(records), std::size(records),
+                          serializer, threads, min_chunk);
+}
+
+} // namespace smallstring
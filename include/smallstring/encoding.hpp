@@ -0,0 +1,222 @@
+/**
+ * @file encoding.hpp
+ * @brief Hex, base64 and fixed-width integer encoders behind
+ *        `push_hex`, `push_base64` and `push_padded`.
+ *
+ * Every encoder knows its exact output size up front and writes straight
+ * into the destination; long inputs are converted 16 bytes at a time.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "integer.hpp"
+#include "simd.hpp"
+
+namespace smallstring {
+namespace detail {
+
+inline constexpr char hex_digits[] = "0123456789abcdef";
+
+inline constexpr char base64_alphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/* ---- Hex -------------------------------------------------------------- */
+
+/// @brief Write `2 * n` lowercase hex digits for the bytes at @p data.
+inline char* write_hex(char* out, const unsigned char* data,
+                       std::size_t n) noexcept {
+    std::size_t i = 0;
+#if defined(SMALLSTRING_HAS_SSE2)
+    {
+        const __m128i low_nibble = _mm_set1_epi8(0x0F);
+        const __m128i nine = _mm_set1_epi8(9);
+        const __m128i zero = _mm_set1_epi8('0');
+        const __m128i letter_gap = _mm_set1_epi8('a' - '0' - 10);
+        // nibble -> '0' + nibble, plus the gap to 'a' for nibbles > 9.
+        const auto to_ascii = [&](__m128i nibbles) {
+            const __m128i gap =
+                _mm_and_si128(_mm_cmpgt_epi8(nibbles, nine), letter_gap);
+            return _mm_add_epi8(_mm_add_epi8(nibbles, zero), gap);
+        };
+        for (; i + 16 <= n; i += 16) {
+            const __m128i v =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            const __m128i high =
+                to_ascii(_mm_and_si128(_mm_srli_epi16(v, 4), low_nibble));
+            const __m128i low = to_ascii(_mm_and_si128(v, low_nibble));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+                             _mm_unpacklo_epi8(high, low));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16),
+                             _mm_unpackhi_epi8(high, low));
+            out += 32;
+        }
+    }
+#elif defined(SMALLSTRING_HAS_NEON)
+    {
+        const uint8x16_t digits =
+            vld1q_u8(reinterpret_cast<const std::uint8_t*>(hex_digits));
+        for (; i + 16 <= n; i += 16) {
+            const uint8x16_t v = vld1q_u8(data + i);
+            uint8x16x2_t pairs;
+            pairs.val[0] = vqtbl1q_u8(digits, vshrq_n_u8(v, 4));
+            pairs.val[1] = vqtbl1q_u8(digits, vandq_u8(v, vdupq_n_u8(0x0F)));
+            vst2q_u8(reinterpret_cast<std::uint8_t*>(out), pairs);
+            out += 32;
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        *out++ = hex_digits[data[i] >> 4];
+        *out++ = hex_digits[data[i] & 0x0F];
+    }
+    return out;
+}
+
+/// @brief Write @p value as exactly `2 * sizeof(T)` hex digits.
+template <typename T>
+constexpr char* write_hex_integer(char* out, T value) noexcept {
+    auto bits = static_cast<std::make_unsigned_t<T>>(value);
+    char* end = out + 2 * sizeof(T);
+    for (char* p = end; p != out; bits >>= 4)
+        *--p = hex_digits[bits & 0x0F];
+    return end;
+}
+
+/* ---- Base64 ----------------------------------------------------------- */
+
+/// @brief Characters `write_base64` emits for @p n input bytes.
+constexpr std::size_t base64_length(std::size_t n) noexcept {
+    return (n + 2) / 3 * 4;
+}
+
+/// @brief Standard (RFC 4648) base64 with `=` padding.
+inline char* write_base64(char* out, const unsigned char* data,
+                          std::size_t n) noexcept {
+    std::size_t i = 0;
+#if defined(SMALLSTRING_HAS_SSSE3)
+    {
+        // 12 input bytes -> 16 characters per step (W. Muła's method).
+        // Each 32-bit lane gets bytes b1 b0 b2 b1; the multiplies move the
+        // four 6-bit fields into separate bytes.
+        const __m128i spread =
+            _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+        const __m128i shift_lut = _mm_setr_epi8(
+            'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+            '/' - 63, 'A', 0, 0);
+        for (; i + 16 <= n; i += 12) {
+            const __m128i in = _mm_shuffle_epi8(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)),
+                spread);
+            const __m128i t0 = _mm_mulhi_epu16(
+                _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)),
+                _mm_set1_epi32(0x04000040));
+            const __m128i t1 = _mm_mullo_epi16(
+                _mm_and_si128(in, _mm_set1_epi32(0x003f03f0)),
+                _mm_set1_epi32(0x01000010));
+            const __m128i indices = _mm_or_si128(t0, t1);
+            // 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12
+            __m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+            range = _mm_or_si128(
+                range, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices),
+                                     _mm_set1_epi8(13)));
+            _mm_storeu_si128(
+                reinterpret_cast<__m128i*>(out),
+                _mm_add_epi8(_mm_shuffle_epi8(shift_lut, range), indices));
+            out += 16;
+        }
+    }
+#elif defined(SMALLSTRING_HAS_NEON)
+    {
+        // 48 input bytes -> 64 characters per step.
+        const std::uint8_t* alphabet =
+            reinterpret_cast<const std::uint8_t*>(base64_alphabet);
+        uint8x16x4_t table;
+        for (int k = 0; k < 4; k++)
+            table.val[k] = vld1q_u8(alphabet + 16 * k);
+        const uint8x16_t six_bits = vdupq_n_u8(0x3F);
+        for (; i + 48 <= n; i += 48) {
+            const uint8x16x3_t in = vld3q_u8(data + i);
+            uint8x16x4_t chars;
+            chars.val[0] = vshrq_n_u8(in.val[0], 2);
+            chars.val[1] = vandq_u8(
+                vorrq_u8(vshlq_n_u8(in.val[0], 4), vshrq_n_u8(in.val[1], 4)),
+                six_bits);
+            chars.val[2] = vandq_u8(
+                vorrq_u8(vshlq_n_u8(in.val[1], 2), vshrq_n_u8(in.val[2], 6)),
+                six_bits);
+            chars.val[3] = vandq_u8(in.val[2], six_bits);
+            for (int k = 0; k < 4; k++)
+                chars.val[k] = vqtbl4q_u8(table, chars.val[k]);
+            vst4q_u8(reinterpret_cast<std::uint8_t*>(out), chars);
+            out += 64;
+        }
+    }
+#endif
+    for (; i + 3 <= n; i += 3) {
+        const std::uint32_t triple = (std::uint32_t(data[i]) << 16) |
+                                     (std::uint32_t(data[i + 1]) << 8) |
+                                     data[i + 2];
+        *out++ = base64_alphabet[triple >> 18];
+        *out++ = base64_alphabet[(triple >> 12) & 0x3F];
+        *out++ = base64_alphabet[(triple >> 6) & 0x3F];
+        *out++ = base64_alphabet[triple & 0x3F];
+    }
+    if (i < n) {
+        const bool two = i + 1 < n;
+        const std::uint32_t triple =
+            (std::uint32_t(data[i]) << 16) |
+            (two ? std::uint32_t(data[i + 1]) << 8 : 0);
+        *out++ = base64_alphabet[triple >> 18];
+        *out++ = base64_alphabet[(triple >> 12) & 0x3F];
+        *out++ = two ? base64_alphabet[(triple >> 6) & 0x3F] : '=';
+        *out++ = '=';
+    }
+    return out;
+}
+
+/* ---- Fixed width ------------------------------------------------------ */
+
+/// @brief Characters `write_padded` emits.
+template <typename T>
+constexpr std::size_t padded_length(T value, std::size_t width) noexcept {
+    const std::size_t length = integer_length(value);
+    return length > width ? length : width;
+}
+
+/**
+ * @brief Write @p value right-aligned in @p width characters.
+ *
+ * With a `'0'` fill the sign goes before the padding ("-0042"), otherwise
+ * after it ("  -42").  Values wider than @p width are written in full.
+ */
+template <typename T>
+SMALLSTRING_CONSTEXPR20 char* write_padded(char* out, T value,
+                                           std::size_t width,
+                                           char fill) noexcept {
+    const std::size_t length = integer_length(value);
+    if (length >= width) {
+        write_integer(out, value, length);
+        return out + length;
+    }
+    char* end = out + width;
+    write_integer(end - length, value, length);
+    char* digits = end - length;
+    if constexpr (std::is_signed<T>::value) {
+        // Move the sign to the front; the fill overwrites the old one.
+        if (fill == '0' && value < 0) {
+            *out++ = '-';
+            digits++;
+        }
+    }
+    std::fill(out, digits, fill);
+    return end;
+}
+
+} // namespace detail
+} // namespace smallstring
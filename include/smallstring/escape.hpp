@@ -0,0 +1,152 @@
+/**
+ * @file escape.hpp
+ * @brief Vectorised JSON string escaping used by `Buffer::push_escaped`.
+ *
+ * Scanning for bytes that need escaping (`"`, `\` and control characters
+ * below 0x20) runs 32 or 16 bytes at a time; the clean runs in between are
+ * block-copied and only the rare escaped bytes take the slow path.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "simd.hpp"
+
+namespace smallstring {
+namespace detail {
+
+/// @brief Whether @p ch must be escaped inside a JSON string.
+inline bool needs_json_escape(char ch) noexcept {
+    const auto byte = static_cast<unsigned char>(ch);
+    return byte < 0x20 || ch == '"' || ch == '\\';
+}
+
+/// @brief Byte-at-a-time `find_json_escape`, used for tails and fallback.
+inline std::size_t find_json_escape_scalar(const char* ptr,
+                                           std::size_t n) noexcept {
+    std::size_t i = 0;
+    while (i < n && !needs_json_escape(ptr[i]))
+        ++i;
+    return i;
+}
+
+/// @brief Index of the first byte in `[ptr, ptr + n)` needing escape, or n.
+inline std::size_t find_json_escape(const char* ptr, std::size_t n) noexcept {
+    std::size_t i = 0;
+#if defined(SMALLSTRING_HAS_AVX2)
+    {
+        const __m256i quote = _mm256_set1_epi8('"');
+        const __m256i backslash = _mm256_set1_epi8('\\');
+        const __m256i control = _mm256_set1_epi8(0x1F);
+        for (; i + 32 <= n; i += 32) {
+            const __m256i v = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(ptr + i));
+            // v <= 0x1F (unsigned) iff min(v, 0x1F) == v.
+            const __m256i hits = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, quote),
+                                _mm256_cmpeq_epi8(v, backslash)),
+                _mm256_cmpeq_epi8(_mm256_min_epu8(v, control), v));
+            const auto mask =
+                static_cast<std::uint32_t>(_mm256_movemask_epi8(hits));
+            if (mask)
+                return i + count_trailing_zeros(mask);
+        }
+    }
+#endif
+#if defined(SMALLSTRING_HAS_SSE2)
+    {
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i control = _mm_set1_epi8(0x1F);
+        for (; i + 16 <= n; i += 16) {
+            const __m128i v =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr + i));
+            const __m128i hits = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(v, quote),
+                             _mm_cmpeq_epi8(v, backslash)),
+                _mm_cmpeq_epi8(_mm_min_epu8(v, control), v));
+            const auto mask =
+                static_cast<std::uint32_t>(_mm_movemask_epi8(hits));
+            if (mask)
+                return i + count_trailing_zeros(mask);
+        }
+    }
+#elif defined(SMALLSTRING_HAS_NEON)
+    {
+        const uint8x16_t quote = vdupq_n_u8('"');
+        const uint8x16_t backslash = vdupq_n_u8('\\');
+        const uint8x16_t control = vdupq_n_u8(0x20);
+        for (; i + 16 <= n; i += 16) {
+            const uint8x16_t v =
+                vld1q_u8(reinterpret_cast<const std::uint8_t*>(ptr + i));
+            const uint8x16_t hits =
+                vorrq_u8(vorrq_u8(vceqq_u8(v, quote), vceqq_u8(v, backslash)),
+                         vcltq_u8(v, control));
+            const std::uint64_t mask = neon_nibble_mask(hits);
+            if (mask)
+                return i + count_trailing_zeros(mask) / 4;
+        }
+    }
+#endif
+    return i + find_json_escape_scalar(ptr + i, n - i);
+}
+
+/// @brief Longest escape sequence `write_json_escape` produces ("\u00XX").
+inline constexpr std::size_t max_json_escape_chars = 6;
+
+/// @brief Write the escape sequence for @p ch; return one past the end.
+inline char* write_json_escape(char* out, char ch) noexcept {
+    static constexpr char hex[] = "0123456789abcdef";
+    *out++ = '\\';
+    switch (ch) {
+    case '"':
+    case '\\':
+        *out++ = ch;
+        break;
+    case '\b':
+        *out++ = 'b';
+        break;
+    case '\f':
+        *out++ = 'f';
+        break;
+    case '\n':
+        *out++ = 'n';
+        break;
+    case '\r':
+        *out++ = 'r';
+        break;
+    case '\t':
+        *out++ = 't';
+        break;
+    default: {
+        const auto byte = static_cast<unsigned char>(ch);
+        *out++ = 'u';
+        *out++ = '0';
+        *out++ = '0';
+        *out++ = hex[byte >> 4];
+        *out++ = hex[byte & 0xF];
+    }
+    }
+    return out;
+}
+
+/// @brief Write @p n bytes at @p ptr JSON-escaped; return one past the end.
+///        @p out needs room for `n * max_json_escape_chars` bytes.
+inline char* write_json_escaped(char* out, const char* ptr,
+                                std::size_t n) noexcept {
+    for (;;) {
+        const std::size_t run = find_json_escape(ptr, n);
+        out = std::copy(ptr, ptr + run, out);
+        if (run == n)
+            return out;
+        out = write_json_escape(out, ptr[run]);
+        ptr += run + 1;
+        n -= run + 1;
+    }
+}
+
+} // namespace detail
+} // namespace smallstring
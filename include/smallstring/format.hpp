@@ -0,0 +1,216 @@
+/**
+ * @file format.hpp
+ * @brief Compile-time format patterns: one `ensure_fit` per message.
+ *
+ * A pattern such as `{"id":{},"px":{}}` is split at compile time into its
+ * literal pieces and `{}` placeholders.  Formatting reserves the worst-case
+ * size of the whole message once (literal bytes plus a bound per argument)
+ * and then writes every piece with unchecked stores.
+ *
+ * @code
+ *   // C++20
+ *   smallstring::format<"{\"id\":{},\"px\":{}}">(buf, id, px);
+ *   // C++17
+ *   SMALLSTRING_FORMAT(buf, "{\"id\":{},\"px\":{}}", id, px);
+ * @endcode
+ *
+ * Arguments may be integers, floating-point values (shortest round-trip
+ * form, as `push`) and anything convertible to `std::string_view` (copied
+ * verbatim).  Every `{}` is a placeholder; there is no escape for a
+ * literal `{}`.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "floating.hpp"
+#include "integer.hpp"
+
+namespace smallstring {
+namespace detail {
+
+constexpr std::size_t count_placeholders(std::string_view pattern) {
+    std::size_t count = 0;
+    for (std::size_t i = 0; i + 1 < pattern.size(); i++) {
+        if (pattern[i] == '{' && pattern[i + 1] == '}') {
+            count++;
+            i++;
+        }
+    }
+    return count;
+}
+
+/// @brief Offsets and lengths of the `Count + 1` literal pieces.
+template <std::size_t Count> struct FormatSegments {
+    std::size_t offset[Count + 1] = {};
+    std::size_t length[Count + 1] = {};
+};
+
+template <std::size_t Count>
+constexpr FormatSegments<Count> split_pattern(std::string_view pattern) {
+    FormatSegments<Count> segments;
+    std::size_t segment = 0;
+    std::size_t start = 0;
+    for (std::size_t i = 0; i + 1 < pattern.size(); i++) {
+        if (pattern[i] == '{' && pattern[i + 1] == '}') {
+            segments.offset[segment] = start;
+            segments.length[segment] = i - start;
+            segment++;
+            start = i + 2;
+            i++;
+        }
+    }
+    segments.offset[Count] = start;
+    segments.length[Count] = pattern.size() - start;
+    return segments;
+}
+
+/// @brief @p Pattern provides `static constexpr std::string_view value()`.
+template <class Pattern> struct CompiledFormat {
+    static constexpr std::string_view text = Pattern::value();
+    static constexpr std::size_t placeholders = count_placeholders(text);
+    static constexpr FormatSegments<placeholders> segments =
+        split_pattern<placeholders>(text);
+    static constexpr std::size_t literal_length =
+        text.size() - 2 * placeholders;
+};
+
+template <class Format, std::size_t I> char* write_segment(char* out) {
+    constexpr std::size_t offset = Format::segments.offset[I];
+    constexpr std::size_t length = Format::segments.length[I];
+    return std::copy(Format::text.data() + offset,
+                     Format::text.data() + offset + length, out);
+}
+
+/* ---- Per-argument size bounds and writers ---------------------------- */
+
+template <typename T>
+using shortest_float_t =
+    std::conditional_t<std::is_same<T, float>::value, float, double>;
+
+template <typename T> std::size_t format_bound(const T& value) {
+    if constexpr (std::is_integral<T>::value) {
+        return max_integer_chars<T>;
+    } else if constexpr (std::is_floating_point<T>::value) {
+        return max_shortest_chars<shortest_float_t<T>>;
+    } else {
+        static_assert(std::is_convertible<const T&, std::string_view>::value,
+                      "format arguments must be arithmetic or string-like");
+        return std::string_view(value).size();
+    }
+}
+
+template <typename T> char* format_arg(char* out, const T& value) {
+    if constexpr (std::is_integral<T>::value) {
+        return format_integer(out, value);
+    } else if constexpr (std::is_floating_point<T>::value) {
+        return format_shortest(out, static_cast<shortest_float_t<T>>(value));
+    } else {
+        const std::string_view view(value);
+        return std::copy(view.begin(), view.end(), out);
+    }
+}
+
+template <class Format, std::size_t... I, class... Args>
+char* format_all(char* out, std::index_sequence<I...>, const Args&... args) {
+    out = write_segment<Format, 0>(out);
+    ((out = write_segment<Format, I + 1>(format_arg(out, args))), ...);
+    return out;
+}
+
+} // namespace detail
+
+/**
+ * @brief Append @p args formatted into the pattern named by @p Pattern.
+ *
+ * @p Pattern is any type with `static constexpr std::string_view value()`;
+ * the C++20 overload and `SMALLSTRING_FORMAT` build one for you.  Works
+ * with every buffer type that has the `PushInterface` primitives.
+ */
+template <class Pattern, class BufferType, class... Args>
+void format(BufferType& buffer, const Args&... args) {
+    using Format = detail::CompiledFormat<Pattern>;
+    static_assert(sizeof...(Args) == Format::placeholders,
+                  "format: argument count does not match the number of {} "
+                  "placeholders");
+    const std::size_t bound =
+        (Format::literal_length + ... + detail::format_bound(args));
+    buffer.ensure_fit(bound);
+    char* out = buffer.tail();
+    buffer.advance(detail::format_all<Format>(
+                       out, std::index_sequence_for<Args...>(), args...) -
+                   out);
+}
+
+namespace detail {
+
+/// @brief Entry point for `SMALLSTRING_FORMAT`; @p Pattern is deduced.
+///        The pattern literal is passed again, and ignored, so that the
+///        macro never has an empty argument list to forward.
+template <class Pattern, class BufferType, std::size_t N, class... Args>
+void format_tagged(Pattern, BufferType& buffer, const char (&)[N],
+                   const Args&... args) {
+    smallstring::format<Pattern>(buffer, args...);
+}
+
+} // namespace detail
+
+#if __cplusplus >= 202002L && defined(__cpp_nontype_template_args) &&          \
+    __cpp_nontype_template_args >= 201911L
+
+namespace detail {
+
+/// @brief String literal usable as a template argument.
+template <std::size_t N> struct FixedString {
+    char data[N] = {};
+
+    constexpr FixedString(const char (&str)[N]) {
+        std::copy(str, str + N, data);
+    }
+};
+
+template <FixedString S> struct FixedPattern {
+    static constexpr std::string_view value() {
+        return std::string_view(S.data, sizeof(S.data) - 1);
+    }
+};
+
+} // namespace detail
+
+/// @brief `format<"{\"id\":{}}">(buf, id)` – pattern as a template argument.
+template <detail::FixedString S, class BufferType, class... Args>
+void format(BufferType& buffer, const Args&... args) {
+    smallstring::format<detail::FixedPattern<S>>(buffer, args...);
+}
+
+#endif
+
+} // namespace smallstring
+
+/**
+ * @brief C++17 spelling of `smallstring::format<"pattern">(buf, args...)`;
+ *        used as `SMALLSTRING_FORMAT(buf, pattern, args...)`.
+ *
+ * The pattern must be a string literal; it may be the only argument after
+ * @p buf.
+ */
+#define SMALLSTRING_FORMAT(buf, ...)                                           \
+    ::smallstring::detail::format_tagged(                                      \
+        [] {                                                                   \
+            struct Pattern {                                                   \
+                static constexpr std::string_view value() {                    \
+                    return SMALLSTRING_DETAIL_FIRST(__VA_ARGS__, ~);           \
+                }                                                              \
+            };                                                                 \
+            return Pattern{};                                                  \
+        }(),                                                                   \
+        buf, __VA_ARGS__)
+
+/// @brief The first of its arguments (callers append a dummy so there is
+///        always a second).
+#define SMALLSTRING_DETAIL_FIRST(first, ...) first
@@ -0,0 +1,170 @@
+/**
+ * @file hash.hpp
+ * @brief Fast non-cryptographic 64-bit hashing of byte strings.
+ *
+ * The function is wyhash (final version 4.2, public domain, by Wang Yi): a
+ * few 64 x 64 -> 128-bit multiplies per 16 bytes of input, with good
+ * distribution in every bit, so the low bits can index a hash table and the
+ * high bits can tag it.  Results are only stable within one build: do not
+ * persist them.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "floating.hpp"
+
+namespace smallstring {
+namespace detail {
+
+inline constexpr std::uint64_t hash_secret[4] = {
+    0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 0x4b33a62ed433d4a3ULL,
+    0x4d5a2da51de1aa47ULL};
+
+/// @brief Fold the 128-bit product of @p a and @p b to 64 bits.
+inline std::uint64_t hash_mix(std::uint64_t a, std::uint64_t b) noexcept {
+    const uint128 product = multiply_64x64(a, b);
+    return product.hi ^ product.lo;
+}
+
+inline std::uint64_t hash_read64(const char* ptr) noexcept {
+    std::uint64_t value;
+    std::memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+inline std::uint64_t hash_read32(const char* ptr) noexcept {
+    std::uint32_t value;
+    std::memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+/// @brief 1-3 bytes, read without branching on the length.
+inline std::uint64_t hash_read_small(const char* ptr, std::size_t n) noexcept {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(ptr);
+    return (std::uint64_t(bytes[0]) << 16) |
+           (std::uint64_t(bytes[n >> 1]) << 8) | bytes[n - 1];
+}
+
+/// @brief Hash the 16 bytes or fewer at @p ptr into the final state.
+inline std::uint64_t hash_finish(const char* ptr, std::size_t n,
+                                 std::size_t total,
+                                 std::uint64_t seed) noexcept {
+    std::uint64_t a, b;
+    if (total <= 16) {
+        if (n >= 4) {
+            const std::size_t step = (n >> 3) << 2;
+            a = (hash_read32(ptr) << 32) | hash_read32(ptr + step);
+            b = (hash_read32(ptr + n - 4) << 32) |
+                hash_read32(ptr + n - 4 - step);
+        } else if (n > 0) {
+            a = hash_read_small(ptr, n);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        // The last 16 bytes, which may overlap bytes already absorbed.
+        a = hash_read64(ptr + n - 16);
+        b = hash_read64(ptr + n - 8);
+    }
+    a ^= hash_secret[1];
+    b ^= seed;
+    const uint128 product = multiply_64x64(a, b);
+    return hash_mix(product.lo ^ hash_secret[0] ^ total,
+                    product.hi ^ hash_secret[1]);
+}
+
+/**
+ * @class IncrementalHash
+ * @brief wyhash of a byte string that grows at the end, absorbed 48-byte
+ *        stripe by stripe as it grows.
+ *
+ * `update(data, n)` absorbs every stripe the one-shot hash of `data[0, n)`
+ * would, so `digest(data, n)` only has the last 48 bytes or fewer left to
+ * mix and equals `hash_bytes(data, n)`.  Both calls must see the same
+ * leading bytes every time; after any change to already-absorbed bytes,
+ * `reset()`.
+ */
+class IncrementalHash {
+  private:
+    std::uint64_t m_start; ///< Seed after the initial mix
+    std::uint64_t m_seed;
+    std::uint64_t m_see1;
+    std::uint64_t m_see2;
+    std::size_t m_stripes; ///< 48-byte stripes absorbed
+
+    /// @brief Stripes the one-shot hash absorbs for @p n bytes: all but
+    ///        the last 1-48 bytes, once there are more than 48.
+    static std::size_t stripes_for(std::size_t n) noexcept {
+        return n > 48 ? (n - 1) / 48 : 0;
+    }
+
+    static void absorb(const char* ptr, std::uint64_t& seed,
+                       std::uint64_t& see1, std::uint64_t& see2) noexcept {
+        seed = hash_mix(hash_read64(ptr) ^ hash_secret[1],
+                        hash_read64(ptr + 8) ^ seed);
+        see1 = hash_mix(hash_read64(ptr + 16) ^ hash_secret[2],
+                        hash_read64(ptr + 24) ^ see1);
+        see2 = hash_mix(hash_read64(ptr + 32) ^ hash_secret[3],
+                        hash_read64(ptr + 40) ^ see2);
+    }
+
+  public:
+    explicit IncrementalHash(std::uint64_t seed = 0) noexcept { reset(seed); }
+
+    /// @brief Forget everything absorbed; start over with @p seed.
+    void reset(std::uint64_t seed = 0) noexcept {
+        m_start = seed ^ hash_mix(seed ^ hash_secret[0], hash_secret[1]);
+        m_seed = m_see1 = m_see2 = m_start;
+        m_stripes = 0;
+    }
+
+    /// @brief Bytes absorbed so far.
+    std::size_t absorbed() const noexcept { return m_stripes * 48; }
+
+    /// @brief Absorb the stripes of `[data, data + n)` not absorbed yet.
+    void update(const char* data, std::size_t n) noexcept {
+        for (const std::size_t target = stripes_for(n); m_stripes < target;
+             m_stripes++)
+            absorb(data + m_stripes * 48, m_seed, m_see1, m_see2);
+    }
+
+    /// @brief `hash_bytes(data, n)`, reusing the absorbed stripes.
+    std::uint64_t digest(const char* data, std::size_t n) const noexcept {
+        if (n <= 16)
+            return hash_finish(data, n, n, m_start);
+        std::uint64_t seed = m_seed, see1 = m_see1, see2 = m_see2;
+        const std::size_t target = stripes_for(n);
+        for (std::size_t stripe = m_stripes; stripe < target; stripe++)
+            absorb(data + stripe * 48, seed, see1, see2);
+        if (target)
+            seed ^= see1 ^ see2;
+        const char* ptr = data + target * 48;
+        std::size_t i = n - target * 48;
+        for (; i > 16; ptr += 16, i -= 16)
+            seed = hash_mix(hash_read64(ptr) ^ hash_secret[1],
+                            hash_read64(ptr + 8) ^ seed);
+        return hash_finish(ptr, i, n, seed);
+    }
+};
+
+/// @brief wyhash of `[ptr, ptr + n)`.
+inline std::uint64_t hash_bytes(const char* ptr, std::size_t n,
+                                std::uint64_t seed = 0) noexcept {
+    return IncrementalHash(seed).digest(ptr, n);
+}
+
+} // namespace detail
+
+/// @brief 64-bit hash of @p bytes (wyhash).
+inline std::uint64_t hash_bytes(std::string_view bytes,
+                                std::uint64_t seed = 0) noexcept {
+    return detail::hash_bytes(bytes.data(), bytes.size(), seed);
+}
+
+} // namespace smallstring
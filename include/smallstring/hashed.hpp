@@ -0,0 +1,121 @@
+/**
+ * @file hashed.hpp
+ * @brief A `Buffer` that keeps a running hash of its contents, for use as
+ *        a cache or dedup key.
+ *
+ * The hash (wyhash, see hash.hpp) is absorbed 48 bytes at a time as they
+ * are pushed, so reading it after building the message costs a constant
+ * amount of work instead of a second pass over the bytes, and comparing
+ * two messages rejects almost every unequal pair on length or hash alone.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+#include "hash.hpp"
+#include "smallstring.hpp"
+
+namespace smallstring {
+
+/**
+ * @class HashedBuffer
+ * @brief A `Buffer` with an O(1) `hash()` of its contents.
+ *
+ * @code
+ *   smallstring::HashedBuffer<> key;
+ *   key.push("snapshot:");
+ *   key.push(instrument_id);
+ *   if (auto it = cache.find(key); it != cache.end()) ...
+ * @endcode
+ *
+ * `hash()` equals `smallstring::hash_bytes(view())`.  `pop` has to rehash
+ * what is left from the start; everything else is incremental.
+ * `std::hash` is specialised, so the type works as an unordered
+ * container key.
+ *
+ * @tparam BufferType The underlying `Buffer` instantiation.
+ */
+template <class BufferType = Buffer<>>
+class HashedBuffer : public PushInterface<HashedBuffer<BufferType>> {
+  private:
+    BufferType m_bytes;
+    detail::IncrementalHash m_hash;
+
+    /// Absorb once this many bytes are pending, so every stripe is hashed
+    /// exactly once and `hash()` never has more than this left to mix.
+    static constexpr std::size_t absorb_after = 96;
+
+  public:
+    explicit HashedBuffer(std::size_t capacity = 256) : m_bytes(capacity) {}
+
+    /// @name Write-side primitives used by `PushInterface`.
+    /// @{
+    void ensure_fit(std::size_t n) { m_bytes.ensure_fit(n); }
+    char* tail() { return m_bytes.tail(); }
+    void advance(std::size_t n) {
+        m_bytes.advance(n);
+        if (m_bytes.length() - m_hash.absorbed() > absorb_after)
+            m_hash.update(m_bytes.head(), m_bytes.length());
+    }
+    /// @}
+
+    /// @brief Hash of `view()`, from the absorbed state plus at most
+    ///        `absorb_after` trailing bytes.
+    std::uint64_t hash() const {
+        return m_hash.digest(m_bytes.head(), m_bytes.length());
+    }
+
+    std::string_view view() const { return m_bytes.view(); }
+    std::size_t length() const { return m_bytes.length(); }
+    const char* head() const { return m_bytes.head(); }
+
+    /// @brief The underlying buffer (read-only: writes would bypass the
+    ///        hash).
+    const BufferType& buffer() const { return m_bytes; }
+
+    void clear() {
+        m_bytes.clear();
+        m_hash.reset();
+    }
+
+    /// @brief Remove the first @p n bytes; the rest is rehashed.
+    void pop(std::size_t n) {
+        m_bytes.pop(n);
+        m_hash.reset();
+        m_hash.update(m_bytes.head(), m_bytes.length());
+    }
+
+    /// @brief `std::string_view::compare` of the contents with @p other.
+    int compare(std::string_view other) const noexcept {
+        return detail::compare_bytes(view(), other);
+    }
+
+    /// @brief Same contents: lengths and hashes first, then a vectorised
+    ///        compare.
+    friend bool operator==(const HashedBuffer& a, const HashedBuffer& b) {
+        return a.length() == b.length() && a.hash() == b.hash() &&
+               detail::find_mismatch(a.head(), b.head(), a.length()) ==
+                   a.length();
+    }
+
+    friend bool operator!=(const HashedBuffer& a, const HashedBuffer& b) {
+        return !(a == b);
+    }
+};
+
+} // namespace smallstring
+
+namespace std {
+
+template <class BufferType> struct hash<smallstring::HashedBuffer<BufferType>> {
+    size_t
+    operator()(const smallstring::HashedBuffer<BufferType>& buffer) const {
+        return static_cast<size_t>(buffer.hash());
+    }
+};
+
+} // namespace std
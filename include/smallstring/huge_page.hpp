@@ -0,0 +1,228 @@
+/**
+ * @file huge_page.hpp
+ * @brief Huge-page, node-local backing memory for large long-lived buffers.
+ *
+ * `std::vector` memory is made of 4 KiB pages placed on whichever NUMA
+ * node first touched them, so a multi-megabyte replay or snapshot buffer
+ * costs a TLB entry per page and may be read across the interconnect.
+ * `HugePageAllocator` maps blocks above a threshold directly with `mmap`,
+ * asks for 2 MiB pages (`MADV_HUGEPAGE`, or `MAP_HUGETLB` from the reserved
+ * pool) and sets a preferred-node policy for the calling thread's node
+ * before any page is touched.  Growth goes through `mremap`, which moves
+ * page table entries rather than bytes.
+ *
+ * Linux only.
+ */
+
+#pragma once
+
+#if defined(__linux__)
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if __has_include(<linux/mempolicy.h>)
+#include <linux/mempolicy.h>
+#endif
+
+#include "smallstring.hpp"
+
+namespace smallstring {
+
+namespace detail {
+
+inline constexpr std::size_t huge_page_size = std::size_t(2) << 20;
+
+inline std::size_t round_up_to_huge_page(std::size_t bytes) {
+    if (bytes > ~std::size_t(0) - huge_page_size)
+        throw std::bad_alloc();
+    return (bytes + huge_page_size - 1) & ~(huge_page_size - 1);
+}
+
+/// @brief Prefer the calling thread's NUMA node for pages of the range;
+///        best effort (no-op without NUMA support or permission).
+inline void prefer_local_node(void* ptr, std::size_t bytes) noexcept {
+#if defined(SYS_mbind) && defined(SYS_getcpu) && defined(MPOL_PREFERRED)
+    unsigned cpu = 0, node = 0;
+    if (::syscall(SYS_getcpu, &cpu, &node, nullptr) != 0)
+        return;
+    constexpr unsigned max_nodes = 1024;
+    unsigned long mask[max_nodes / (8 * sizeof(unsigned long))] = {};
+    if (node >= max_nodes)
+        return;
+    mask[node / (8 * sizeof(unsigned long))] |=
+        1UL << (node % (8 * sizeof(unsigned long)));
+    // The kernel reads `maxnode - 1` bits.
+    ::syscall(SYS_mbind, ptr, bytes, MPOL_PREFERRED, mask, max_nodes + 1,
+              0);
+#else
+    (void)ptr;
+    (void)bytes;
+#endif
+}
+
+/**
+ * @brief Map @p bytes (a multiple of `huge_page_size`) of anonymous memory
+ *        backed by huge pages where possible, local to the calling thread.
+ *
+ * Transparent huge pages need a 2 MiB aligned range, which `mmap` does not
+ * promise, so a slightly larger range is mapped and the ends trimmed.
+ */
+inline void* map_huge_pages(std::size_t bytes, bool explicit_pages) {
+#if defined(MAP_HUGETLB)
+    if (explicit_pages) {
+        void* ptr = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (ptr != MAP_FAILED) {
+            prefer_local_node(ptr, bytes);
+            return ptr;
+        }
+        // The reserved pool is empty or absent: fall back to THP.
+    }
+#else
+    (void)explicit_pages;
+#endif
+    const std::size_t padded = bytes + huge_page_size;
+    void* raw = ::mmap(nullptr, padded, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED)
+        throw std::bad_alloc();
+    char* const base = static_cast<char*>(raw);
+    const auto address = reinterpret_cast<std::uintptr_t>(base);
+    char* const aligned =
+        base + ((huge_page_size - address % huge_page_size) % huge_page_size);
+    if (aligned != base)
+        ::munmap(base, static_cast<std::size_t>(aligned - base));
+    if (const std::size_t after = padded - (aligned - base) - bytes)
+        ::munmap(aligned + bytes, after);
+#if defined(MADV_HUGEPAGE)
+    ::madvise(aligned, bytes, MADV_HUGEPAGE);
+#endif
+    prefer_local_node(aligned, bytes);
+    return aligned;
+}
+
+} // namespace detail
+
+/**
+ * @class HugePageAllocator
+ * @brief STL allocator that backs blocks of @p Threshold bytes or more with
+ *        node-local huge pages; smaller blocks come from `std::allocator`.
+ *
+ * Mapped blocks are rounded up to whole 2 MiB pages.  With @p Explicit set,
+ * pages are taken from the `MAP_HUGETLB` pool when it has room, falling
+ * back to transparent huge pages otherwise.
+ *
+ * The allocator has `reallocate`, so as `ReallocStorage`'s allocator a
+ * mapped block grows with `mremap` instead of a copy; `HugePageBuffer` is
+ * that combination.  Memory policy and huge-page advice belong to the
+ * mapping and move with it, so a grown buffer stays on the node that first
+ * allocated it.
+ *
+ * @code
+ *   smallstring::HugePageBuffer<> replay(64 << 20); // on this thread's node
+ * @endcode
+ */
+template <class T, std::size_t Threshold = detail::huge_page_size,
+          bool Explicit = false>
+class HugePageAllocator {
+  public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    template <class U>
+    using rebound = HugePageAllocator<U, Threshold, Explicit>;
+
+    template <class U> struct rebind {
+        using other = rebound<U>;
+    };
+
+    static constexpr std::size_t threshold = Threshold;
+
+    HugePageAllocator() = default;
+
+    template <class U> HugePageAllocator(const rebound<U>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        if (!is_mapped(n))
+            return std::allocator<T>().allocate(n);
+        return static_cast<T*>(
+            detail::map_huge_pages(mapped_bytes(n), Explicit));
+    }
+
+    void deallocate(T* ptr, std::size_t n) noexcept {
+        if (!is_mapped(n))
+            std::allocator<T>().deallocate(ptr, n);
+        else
+            ::munmap(ptr, mapped_bytes(n));
+    }
+
+    /**
+     * @brief Resize @p ptr from @p old_n to @p new_n elements, keeping the
+     *        first @p used.
+     *
+     * A mapped block is remapped; the bytes are copied only when crossing
+     * the threshold or when the kernel refuses (`MAP_HUGETLB` mappings on
+     * older kernels).  On failure @p ptr is left intact.
+     */
+    T* reallocate(T* ptr, std::size_t old_n, std::size_t new_n,
+                  std::size_t used) {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "reallocate moves bytes");
+        if (is_mapped(old_n) && is_mapped(new_n)) {
+            const std::size_t old_bytes = mapped_bytes(old_n);
+            const std::size_t new_bytes = mapped_bytes(new_n);
+            if (old_bytes == new_bytes)
+                return ptr;
+            void* moved =
+                ::mremap(ptr, old_bytes, new_bytes, MREMAP_MAYMOVE);
+            if (moved != MAP_FAILED)
+                return static_cast<T*>(moved);
+        }
+        T* fresh = allocate(new_n);
+        if (used)
+            std::memcpy(fresh, ptr, used * sizeof(T));
+        deallocate(ptr, old_n);
+        return fresh;
+    }
+
+    /// @brief Whether a block of @p n elements is mapped by this allocator.
+    static bool is_mapped(std::size_t n) noexcept {
+        return n >= Threshold / sizeof(T) + (Threshold % sizeof(T) != 0);
+    }
+
+    template <class U> bool operator==(const rebound<U>&) const noexcept {
+        return true;
+    }
+
+    template <class U> bool operator!=(const rebound<U>&) const noexcept {
+        return false;
+    }
+
+  private:
+    static std::size_t mapped_bytes(std::size_t n) {
+        if (n > ~std::size_t(0) / sizeof(T))
+            throw std::bad_alloc();
+        return detail::round_up_to_huge_page(n * sizeof(T));
+    }
+};
+
+/// @brief A `Buffer` whose storage moves to node-local huge pages once it
+///        reaches @p Threshold bytes, and then grows with `mremap`.
+template <std::size_t Threshold = detail::huge_page_size,
+          class Growth = DoublingGrowth, class Stats = NoStats>
+using HugePageBuffer =
+    Buffer<HugePageAllocator<char, Threshold>, Growth,
+           ReallocStorage<HugePageAllocator<char, Threshold>>, Stats>;
+
+} // namespace smallstring
+
+#endif // __linux__
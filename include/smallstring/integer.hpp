@@ -0,0 +1,174 @@
+/**
+ * @file integer.hpp
+ * @brief Branch-light base-10 integer formatting used by `Buffer`.
+ *
+ * Digit counting uses log2 (count-leading-zeros) plus a power-of-ten table,
+ * and digits are written right-to-left two at a time from a 200-byte table.
+ * Everything here writes into caller-provided memory and never allocates,
+ * and is `constexpr`, so `StaticBuffer` can format integers at compile time.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h> // _BitScanReverse64
+#endif
+
+/// `constexpr` from C++20 on, where `std::copy` / `std::fill` are: marks
+/// the `push` overloads that `StaticBuffer` can run at compile time.
+#if __cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+#define SMALLSTRING_CONSTEXPR20 constexpr
+#define SMALLSTRING_HAS_CONSTEXPR_PUSH 1
+#else
+#define SMALLSTRING_CONSTEXPR20
+#endif
+
+namespace smallstring {
+namespace detail {
+
+/* ------------------------------------------------------------------------- */
+/*                          Integer formatting                               */
+/* ------------------------------------------------------------------------- */
+
+/// @brief "00" "01" … "99" – lets the writer emit two digits per division.
+inline constexpr char digit_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/// @brief Thresholds for `count_digits`; entry 0 is 0 so that 0 has 1 digit.
+inline constexpr std::uint64_t digit_thresholds[20] = {
+    0ULL,
+    10ULL,
+    100ULL,
+    1000ULL,
+    10000ULL,
+    100000ULL,
+    1000000ULL,
+    10000000ULL,
+    100000000ULL,
+    1000000000ULL,
+    10000000000ULL,
+    100000000000ULL,
+    1000000000000ULL,
+    10000000000000ULL,
+    100000000000000ULL,
+    1000000000000000ULL,
+    10000000000000000ULL,
+    100000000000000000ULL,
+    1000000000000000000ULL,
+    10000000000000000000ULL,
+};
+
+/// @brief Index of the highest set bit of `n | 1`.
+constexpr unsigned log2_floor(std::uint64_t n) noexcept {
+    n |= 1;
+#if defined(__GNUC__) || defined(__clang__)
+    return 63U ^ static_cast<unsigned>(__builtin_clzll(n));
+#else
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64)) &&           \
+    defined(__cpp_lib_is_constant_evaluated)
+    if (!std::is_constant_evaluated()) {
+        unsigned long index;
+        _BitScanReverse64(&index, n);
+        return static_cast<unsigned>(index);
+    }
+#endif
+    unsigned index = 0;
+    while (n >>= 1)
+        ++index;
+    return index;
+#endif
+}
+
+/// @brief Number of base-10 digits in @p n (1 for 0), without dividing.
+constexpr std::size_t count_digits(std::uint64_t n) noexcept {
+    // (log2(n) + 1) * log10(2) approximated as * 1233 / 4096 is either the
+    // digit count or one too many; the threshold table settles which.
+    const unsigned approx = ((log2_floor(n) + 1) * 1233U) >> 12;
+    return approx + 1 - (n < digit_thresholds[approx]);
+}
+
+/// @brief Unsigned type wide enough to hold |T| for every T value.
+template <typename T>
+using magnitude_t =
+    std::conditional_t<(sizeof(T) <= sizeof(std::uint32_t)), std::uint32_t,
+                       std::uint64_t>;
+
+/// @brief |@p value| as an unsigned integer; well defined for the minimum.
+template <typename T>
+constexpr magnitude_t<T> magnitude(T value) noexcept {
+    using U = magnitude_t<T>;
+    if constexpr (std::is_signed<T>::value) {
+        if (value < 0)
+            return U(0) - static_cast<U>(value);
+    }
+    return static_cast<U>(value);
+}
+
+/// @brief Upper bound on the characters `write_integer` emits for a `T`.
+template <typename T>
+inline constexpr std::size_t max_integer_chars =
+    std::numeric_limits<T>::digits10 + 1 + std::is_signed<T>::value;
+
+/// @brief Characters needed to print @p value in base 10 (sign included).
+template <typename T>
+constexpr std::size_t integer_length(T value) noexcept {
+    std::size_t sign = 0;
+    if constexpr (std::is_signed<T>::value)
+        sign = value < 0;
+    return sign + count_digits(magnitude(value));
+}
+
+/**
+ * @brief Write @p value into `[out, out + length)`.
+ *
+ * @p length must be `integer_length(value)`.  Digits are produced
+ * right-to-left two at a time from `digit_pairs`.
+ */
+template <typename T>
+constexpr void write_integer(char* out, T value,
+                             std::size_t length) noexcept {
+    auto n = magnitude(value);
+    if constexpr (std::is_signed<T>::value) {
+        if (value < 0)
+            *out = '-';
+    }
+    char* end = out + length;
+    while (n >= 100) {
+        const auto pair = static_cast<std::size_t>(n % 100) * 2;
+        n /= 100;
+        *--end = digit_pairs[pair + 1];
+        *--end = digit_pairs[pair];
+    }
+    if (n >= 10) {
+        const auto pair = static_cast<std::size_t>(n) * 2;
+        *--end = digit_pairs[pair + 1];
+        *--end = digit_pairs[pair];
+    } else {
+        *--end = static_cast<char>('0' + n);
+    }
+}
+
+/// @brief Write @p value at @p out and return one past the last character.
+template <typename T>
+constexpr char* format_integer(char* out, T value) noexcept {
+    const std::size_t length = integer_length(value);
+    write_integer(out, value, length);
+    return out + length;
+}
+
+} // namespace detail
+} // namespace smallstring
@@ -0,0 +1,396 @@
+/**
+ * @file intern.hpp
+ * @brief Interning of repeated short strings (symbols, venue codes, field
+ *        keys) to stable integer ids with cached JSON forms.
+ *
+ * The index is a SwissTable-style open-addressing table: one control byte
+ * per slot holds 7 bits of the hash, and a probe compares a whole 16-byte
+ * group of control bytes against the hash with one vector compare, so a
+ * lookup usually touches one cache line of control bytes and one entry.
+ * Entries are never removed; ids are dense and assigned in insertion order.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "hash.hpp"
+#include "integer.hpp"
+#include "simd.hpp"
+#include "smallstring.hpp"
+
+namespace smallstring {
+
+/* ------------------------------------------------------------------------- */
+/*                              Concurrency modes                            */
+/* ------------------------------------------------------------------------- */
+
+/// @brief No synchronisation: one thread uses the table at a time.
+struct InternSingleThread {
+    static constexpr bool concurrent = false;
+};
+
+/**
+ * @brief Lock-free lookups, serialised inserts.
+ *
+ * Lookups probe an immutable snapshot of the index and only take the lock
+ * on a miss.  Inserts take the lock and republish the snapshot once the
+ * table has grown by a quarter (or on `publish()`).  Superseded snapshots
+ * are kept until the table is destroyed, roughly 5x the final index size
+ * in total.
+ */
+struct InternReadMostly {
+    static constexpr bool concurrent = true;
+};
+
+namespace detail {
+
+/**
+ * @class InternIndex
+ * @brief Hash -> id map with SwissTable-style group probing.
+ *
+ * Slots come in groups of 16.  A control byte is `empty` or the
+ * low 7 bits of the hash; the rest of the hash picks the first group, and
+ * groups are then probed in triangular order.  The caller checks candidate
+ * ids against its own key and keeps the load at 7/8 or below.
+ */
+class InternIndex {
+  public:
+    static constexpr std::size_t group_size = 16;
+    static constexpr std::uint32_t npos = ~std::uint32_t(0);
+
+  private:
+    static constexpr std::int8_t empty = -128;
+
+    std::size_t m_group_mask;
+    std::size_t m_size = 0;
+    std::unique_ptr<std::int8_t[]> m_control;
+    std::unique_ptr<std::uint32_t[]> m_ids;
+
+    /// @brief Bit per slot of @p group whose control byte equals @p tag.
+    static std::uint32_t match(const std::int8_t* group,
+                               std::int8_t tag) noexcept {
+#if defined(SMALLSTRING_HAS_SSE2)
+        const __m128i control =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+        return static_cast<std::uint32_t>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(control, _mm_set1_epi8(tag))));
+#elif defined(SMALLSTRING_HAS_NEON)
+        const uint8x16_t control =
+            vld1q_u8(reinterpret_cast<const std::uint8_t*>(group));
+        std::uint64_t nibbles = neon_nibble_mask(
+            vceqq_u8(control, vdupq_n_u8(static_cast<std::uint8_t>(tag))));
+        // One bit per lane: gather bit 4k of the nibble mask into bit k.
+        std::uint32_t mask = 0;
+        for (nibbles &= 0x1111111111111111ULL; nibbles; nibbles &= nibbles - 1)
+            mask |= 1U << (count_trailing_zeros(nibbles) / 4);
+        return mask;
+#else
+        std::uint32_t mask = 0;
+        for (std::size_t i = 0; i < group_size; i++)
+            mask |= std::uint32_t(group[i] == tag) << i;
+        return mask;
+#endif
+    }
+
+    static std::int8_t tag(std::uint64_t hash) noexcept {
+        return static_cast<std::int8_t>(hash & 0x7F);
+    }
+
+  public:
+    /// @brief An index of @p groups groups (a power of two).
+    explicit InternIndex(std::size_t groups)
+        : m_group_mask(groups - 1),
+          m_control(new std::int8_t[groups * group_size]),
+          m_ids(new std::uint32_t[groups * group_size]) {
+        std::memset(m_control.get(), empty, groups * group_size);
+    }
+
+    InternIndex(const InternIndex& other)
+        : InternIndex(other.m_group_mask + 1) {
+        m_size = other.m_size;
+        std::memcpy(m_control.get(), other.m_control.get(), capacity());
+        std::memcpy(m_ids.get(), other.m_ids.get(),
+                    capacity() * sizeof(std::uint32_t));
+    }
+
+    InternIndex(InternIndex&&) noexcept = default;
+    InternIndex& operator=(InternIndex&&) noexcept = default;
+    InternIndex& operator=(const InternIndex&) = delete;
+
+    std::size_t capacity() const { return (m_group_mask + 1) * group_size; }
+    std::size_t size() const { return m_size; }
+
+    /// @brief Whether one more insert would push the load past 7/8.
+    bool full() const { return (m_size + 1) * 8 > capacity() * 7; }
+
+    /// @brief The id for which `equal(id)` holds, or `npos`.
+    template <class Equal>
+    std::uint32_t find(std::uint64_t hash, Equal&& equal) const {
+        const std::int8_t wanted = tag(hash);
+        std::size_t group = (hash >> 7) & m_group_mask;
+        for (std::size_t step = 1;; step++) {
+            const std::int8_t* control = m_control.get() + group * group_size;
+            for (std::uint32_t hits = match(control, wanted); hits;
+                 hits &= hits - 1) {
+                const std::uint32_t id =
+                    m_ids[group * group_size + count_trailing_zeros(hits)];
+                if (equal(id))
+                    return id;
+            }
+            if (match(control, empty))
+                return npos;
+            group = (group + step) & m_group_mask;
+        }
+    }
+
+    /// @brief Add @p id under @p hash; it must not be present yet, and
+    ///        the index must not be `full()`.
+    void insert(std::uint64_t hash, std::uint32_t id) {
+        std::size_t group = (hash >> 7) & m_group_mask;
+        for (std::size_t step = 1;; step++) {
+            std::int8_t* control = m_control.get() + group * group_size;
+            if (const std::uint32_t free = match(control, empty)) {
+                const std::size_t slot = count_trailing_zeros(free);
+                m_ids[group * group_size + slot] = id;
+                control[slot] = tag(hash);
+                m_size++;
+                return;
+            }
+            group = (group + step) & m_group_mask;
+        }
+    }
+};
+
+} // namespace detail
+
+/**
+ * @class InternTable
+ * @brief Maps strings to dense, stable ids and caches their JSON strings.
+ *
+ * @code
+ *   smallstring::InternTable<> symbols;
+ *   const auto id = symbols.intern("AAPL");   // once, on first sight
+ *   // per message:
+ *   buf.push("{\"sym\":");
+ *   buf.push_interned(symbols, id);           // "\"AAPL\"", fixed copy
+ *   buf.push("}");
+ * @endcode
+ *
+ * Each id keeps its original bytes (`name`) and the quoted, JSON-escaped
+ * form (`json`).  JSON forms up to `inline_json` bytes are stored in a
+ * fixed-size slot, and `push_interned` copies the whole slot in one go
+ * before advancing by the real length; longer ones are pushed normally.
+ * Views returned by `name` / `json` stay valid for the table's lifetime.
+ *
+ * @tparam Mode `InternSingleThread` (default) or `InternReadMostly`.
+ */
+template <class Mode = InternSingleThread> class InternTable {
+  public:
+    using id_type = std::uint32_t;
+    static constexpr id_type npos = detail::InternIndex::npos;
+    /// JSON forms up to this size are copied as one fixed-size block.
+    static constexpr std::size_t inline_json = 32;
+
+  private:
+    struct Entry {
+        char json_slot[inline_json]; ///< json, zero-padded (if it fits)
+        std::uint64_t hash;
+        std::string_view name;
+        std::string_view json;
+    };
+
+    /// Chunk k holds `first_chunk << k` entries, so entries never move.
+    static constexpr std::size_t first_chunk = 64;
+    static constexpr std::size_t max_chunks = 27;
+    static constexpr std::size_t text_block = 16 * 1024;
+
+    std::unique_ptr<Entry[]> m_chunks[max_chunks];
+    std::vector<std::unique_ptr<char[]>> m_text; ///< Names and JSON forms
+    char* m_text_next = nullptr;
+    std::size_t m_text_left = 0;
+    std::atomic<std::size_t> m_size{0};
+    detail::InternIndex m_index;
+
+    // InternReadMostly only.
+    mutable std::mutex m_mutex;
+    std::atomic<const detail::InternIndex*> m_snapshot{nullptr};
+    std::vector<std::unique_ptr<detail::InternIndex>> m_snapshots;
+
+    static std::size_t chunk_of(id_type id) {
+        return detail::log2_floor(id / first_chunk + 1);
+    }
+
+    /// @brief Index of @p id within its chunk.
+    static std::size_t chunk_offset(id_type id, std::size_t chunk) {
+        return id - first_chunk * ((std::size_t(1) << chunk) - 1);
+    }
+
+    const Entry& entry(id_type id) const {
+        const std::size_t chunk = chunk_of(id);
+        return m_chunks[chunk][chunk_offset(id, chunk)];
+    }
+
+    static std::size_t groups_for(std::size_t expected) {
+        std::size_t groups = 1;
+        while (groups * detail::InternIndex::group_size * 7 < expected * 8)
+            groups *= 2;
+        return groups;
+    }
+
+    /// @brief @p n bytes of stable storage for names and JSON forms.
+    char* allocate_text(std::size_t n) {
+        if (n > m_text_left) {
+            m_text_left = n > text_block ? n : text_block;
+            m_text.emplace_back(new char[m_text_left]);
+            m_text_next = m_text.back().get();
+        }
+        char* out = m_text_next;
+        m_text_next += n;
+        m_text_left -= n;
+        return out;
+    }
+
+    template <class Index>
+    static id_type lookup(const Index& index, const InternTable& table,
+                          std::string_view name, std::uint64_t hash) {
+        return index.find(hash, [&](id_type id) {
+            const Entry& candidate = table.entry(id);
+            return candidate.hash == hash && candidate.name == name;
+        });
+    }
+
+    id_type insert(std::string_view name, std::uint64_t hash) {
+        const auto id = static_cast<id_type>(m_size.load(
+            std::memory_order_relaxed));
+        const std::size_t chunk = chunk_of(id);
+        if (!m_chunks[chunk])
+            m_chunks[chunk].reset(new Entry[first_chunk << chunk]);
+        Entry& slot = m_chunks[chunk][chunk_offset(id, chunk)];
+
+        Buffer<> json(name.size() + 2);
+        json.push("\"");
+        json.push_escaped(name);
+        json.push("\"");
+        char* text = allocate_text(name.size() + json.length());
+        std::memcpy(text, name.data(), name.size());
+        std::memcpy(text + name.size(), json.head(), json.length());
+        slot.hash = hash;
+        slot.name = std::string_view(text, name.size());
+        slot.json = std::string_view(text + name.size(), json.length());
+        std::memset(slot.json_slot, 0, inline_json);
+        if (json.length() <= inline_json)
+            std::memcpy(slot.json_slot, json.head(), json.length());
+
+        if (m_index.full()) {
+            detail::InternIndex grown(
+                groups_for(m_index.size() * 2 + first_chunk));
+            for (id_type other = 0; other < id; other++)
+                grown.insert(entry(other).hash, other);
+            m_index = std::move(grown);
+        }
+        m_index.insert(hash, id);
+        m_size.store(id + 1, std::memory_order_release);
+        return id;
+    }
+
+  public:
+    /// @brief A table sized for @p expected entries before it grows.
+    explicit InternTable(std::size_t expected = 0)
+        : m_index(groups_for(expected)) {}
+
+    InternTable(const InternTable&) = delete;
+    InternTable& operator=(const InternTable&) = delete;
+
+    /// @brief The id of @p name, adding it if new.
+    id_type intern(std::string_view name) {
+        const std::uint64_t hash = hash_bytes(name);
+        if constexpr (Mode::concurrent) {
+            if (const auto* snapshot =
+                    m_snapshot.load(std::memory_order_acquire)) {
+                const id_type id = lookup(*snapshot, *this, name, hash);
+                if (id != npos)
+                    return id;
+            }
+            std::lock_guard<std::mutex> lock(m_mutex);
+            id_type id = lookup(m_index, *this, name, hash);
+            if (id == npos) {
+                id = insert(name, hash);
+                const auto* snapshot =
+                    m_snapshot.load(std::memory_order_relaxed);
+                const std::size_t published = snapshot ? snapshot->size() : 0;
+                if ((m_index.size() - published) * 4 >= published)
+                    publish_locked();
+            }
+            return id;
+        } else {
+            const id_type id = lookup(m_index, *this, name, hash);
+            return id != npos ? id : insert(name, hash);
+        }
+    }
+
+    /// @brief The id of @p name, or `npos` if it was never interned.
+    id_type find(std::string_view name) const {
+        const std::uint64_t hash = hash_bytes(name);
+        if constexpr (Mode::concurrent) {
+            if (const auto* snapshot =
+                    m_snapshot.load(std::memory_order_acquire)) {
+                const id_type id = lookup(*snapshot, *this, name, hash);
+                if (id != npos)
+                    return id;
+            }
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return lookup(m_index, *this, name, hash);
+        } else {
+            return lookup(m_index, *this, name, hash);
+        }
+    }
+
+    /// @brief Make every entry so far visible to lock-free lookups
+    ///        (`InternReadMostly`; e.g. after loading a symbol list).
+    void publish() {
+        if constexpr (Mode::concurrent) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            publish_locked();
+        }
+    }
+
+    /// @brief Number of interned strings; ids are `[0, size())`.
+    std::size_t size() const {
+        return m_size.load(std::memory_order_acquire);
+    }
+
+    /// @brief The interned bytes of @p id.
+    std::string_view name(id_type id) const { return entry(id).name; }
+
+    /// @brief @p id as a quoted, JSON-escaped string.
+    std::string_view json(id_type id) const { return entry(id).json; }
+
+    /// @brief Append `json(id)` to @p out; see `Buffer::push_interned`.
+    template <class Out> void push_json(Out& out, id_type id) const {
+        const Entry& e = entry(id);
+        if (e.json.size() > inline_json) {
+            out.push(e.json);
+            return;
+        }
+        out.ensure_fit(inline_json);
+        std::memcpy(out.tail(), e.json_slot, inline_json);
+        out.advance(e.json.size());
+    }
+
+  private:
+    void publish_locked() {
+        m_snapshots.push_back(std::make_unique<detail::InternIndex>(m_index));
+        m_snapshot.store(m_snapshots.back().get(), std::memory_order_release);
+    }
+};
+
+} // namespace smallstring
@@ -0,0 +1,248 @@
+/**
+ * @file json.hpp
+ * @brief Streaming, allocation-free JSON writer layered on `Buffer`.
+ *
+ * `smallstring::JsonWriter` only tracks where commas go: it writes straight
+ * into the wrapped buffer and keeps one bit of state per nesting level, so
+ * building a message costs the same as the hand-rolled pushes it replaces.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath> // std::isfinite
+#include <cstddef>
+#include <cstdint>
+#include <cstring> // std::memcpy
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "smallstring.hpp"
+
+namespace smallstring {
+
+/**
+ * @class JsonWriter
+ * @brief Writes JSON tokens into a `Buffer`, inserting commas as needed.
+ *
+ * @tparam BufferType Any `smallstring::Buffer` instantiation.
+ *
+ * Typical usage
+ * @code
+ *   smallstring::Buffer<> buf;
+ *   smallstring::JsonWriter json(buf);
+ *   json.begin_object();
+ *   json.key("id");
+ *   json.value(42);
+ *   json.key("px");
+ *   json.value_fixed(101.25, 2);
+ *   json.key("tags");
+ *   json.begin_array();
+ *   json.value("a");
+ *   json.value(true);
+ *   json.end_array();
+ *   json.end_object();
+ *   // buf.view() == R"({"id":42,"px":101.25,"tags":["a",true]})"
+ * @endcode
+ *
+ * Nesting is limited to `max_depth` levels (checked with `assert`).  The
+ * writer holds a reference to the buffer and must not outlive it.
+ */
+template <class BufferType> class JsonWriter {
+  public:
+    static constexpr std::size_t max_depth = 63;
+
+  private:
+    BufferType& m_buffer;
+    std::uint64_t m_commas = 0; ///< Bit d set: level d needs a comma
+    std::size_t m_depth = 0;    ///< Current nesting level
+    bool m_after_key = false;   ///< The next value belongs to a key
+
+    /// @brief Consume the separator state for the next element.
+    ///
+    /// Returns whether a comma must precede it.  Level 0 (the top-level
+    /// value) never takes a comma.
+    bool next_needs_comma() {
+        if (m_after_key) {
+            m_after_key = false;
+            return false;
+        }
+        const std::uint64_t bit = std::uint64_t(1) << m_depth;
+        const bool comma = (m_commas & bit & ~std::uint64_t(1)) != 0;
+        m_commas |= bit;
+        return comma;
+    }
+
+    void separate() {
+        if (next_needs_comma()) {
+            m_buffer.ensure_fit(1);
+            *m_buffer.tail() = ',';
+            m_buffer.advance(1);
+        }
+    }
+
+    void open(char bracket) {
+        assert(m_depth < max_depth && "JsonWriter nesting too deep");
+        const bool comma = next_needs_comma();
+        m_buffer.ensure_fit(2);
+        char* out = m_buffer.tail();
+        *out = ',';
+        out += comma;
+        *out = bracket;
+        m_buffer.advance(1 + comma);
+        ++m_depth;
+        m_commas &= ~(std::uint64_t(1) << m_depth);
+    }
+
+    void close(char bracket) {
+        assert(m_depth > 0 && !m_after_key && "unbalanced JsonWriter close");
+        --m_depth;
+        m_buffer.ensure_fit(1);
+        *m_buffer.tail() = bracket;
+        m_buffer.advance(1);
+    }
+
+    /// One reservation for the quoted string, so a fixed-capacity buffer
+    /// keeps or drops it whole.  Only the bytes from the first escape on
+    /// reserve the worst case; nearly all keys reserve their exact size.
+    void write_string(std::string_view str) {
+        const std::size_t plain =
+            detail::find_json_escape(str.data(), str.size());
+        const std::size_t rest = str.size() - plain;
+        m_buffer.ensure_fit(2 + plain + rest * detail::max_json_escape_chars);
+        char* const begin = m_buffer.tail();
+        char* out = begin;
+        *out++ = '"';
+        out = std::copy(str.data(), str.data() + plain, out);
+        if (rest)
+            out = detail::write_json_escaped(out, str.data() + plain, rest);
+        *out++ = '"';
+        m_buffer.advance(static_cast<std::size_t>(out - begin));
+    }
+
+  public:
+    explicit JsonWriter(BufferType& buffer) : m_buffer(buffer) {}
+
+    /// @brief The buffer being written to.
+    BufferType& buffer() { return m_buffer; }
+
+    /// @brief Current nesting level (0 once the top-level value is closed).
+    std::size_t depth() const { return m_depth; }
+
+    /// @brief Forget all state, e.g. between newline-delimited messages.
+    void reset() {
+        m_commas = 0;
+        m_depth = 0;
+        m_after_key = false;
+    }
+
+    /* --------------------------------------------------------------------- */
+    /*                               Structure                               */
+    /* --------------------------------------------------------------------- */
+
+    void begin_object() { open('{'); }
+    void end_object() { close('}'); }
+    void begin_array() { open('['); }
+    void end_array() { close(']'); }
+
+    /**
+     * @brief Write a literal key, e.g. `key("px")` -> `"px":`.
+     *
+     * The size is known at compile time, so the comma, quotes, name and
+     * colon are written with one `ensure_fit` and fixed-size copies.  The
+     * literal is copied verbatim and must not need escaping.
+     */
+    template <std::size_t N> void key(const char (&name)[N]) {
+        assert(m_depth > 0 && !m_after_key && "key outside of an object");
+        const bool comma = next_needs_comma();
+        m_buffer.ensure_fit(N + 3);
+        char* out = m_buffer.tail();
+        *out = ',';
+        out += comma;
+        *out++ = '"';
+        std::memcpy(out, name, N - 1);
+        out += N - 1;
+        *out++ = '"';
+        *out = ':';
+        m_buffer.advance(N + 2 + comma);
+        m_after_key = true;
+    }
+
+    /// @brief Write a runtime key, escaping it as needed.
+    void key(std::string_view name) {
+        assert(m_depth > 0 && !m_after_key && "key outside of an object");
+        separate();
+        write_string(name);
+        m_buffer.push(":");
+        m_after_key = true;
+    }
+
+    /* --------------------------------------------------------------------- */
+    /*                                Values                                 */
+    /* --------------------------------------------------------------------- */
+
+    /**
+     * @brief Write a number, or `true` / `false` for `bool`.
+     *
+     * JSON has no NaN or infinity; like `JSON.stringify`, non-finite
+     * floating-point values are written as `null`.
+     */
+    template <typename T,
+              std::enable_if_t<std::is_arithmetic<T>::value, int> = 0>
+    void value(T number) {
+        separate();
+        if constexpr (std::is_same<T, bool>::value) {
+            if (number)
+                m_buffer.push("true");
+            else
+                m_buffer.push("false");
+        } else if constexpr (std::is_floating_point<T>::value) {
+            if (std::isfinite(number))
+                m_buffer.push(number);
+            else
+                m_buffer.push("null");
+        } else {
+            m_buffer.push(number);
+        }
+    }
+
+    /// @brief Write @p number with exactly @p precision fractional digits;
+    ///        `null` if it is not finite.
+    template <typename T,
+              std::enable_if_t<std::is_floating_point<T>::value, int> = 0>
+    void value_fixed(T number, std::size_t precision) {
+        separate();
+        if (std::isfinite(number))
+            m_buffer.push_fixed(number, precision);
+        else
+            m_buffer.push("null");
+    }
+
+    /// @brief Write an escaped, quoted string.
+    void value(std::string_view str) {
+        separate();
+        write_string(str);
+    }
+
+    /// @brief Write an escaped, quoted string.
+    void value(const char* str) { value(std::string_view(str)); }
+
+    /// @brief Write an escaped, quoted string.
+    void value(const std::string& str) { value(std::string_view(str)); }
+
+    /// @brief Write `null`.
+    void value(std::nullptr_t) {
+        separate();
+        m_buffer.push("null");
+    }
+
+    /// @brief Write pre-serialised JSON verbatim as the next value.
+    void raw(std::string_view json) {
+        separate();
+        m_buffer.push(json);
+    }
+};
+
+} // namespace smallstring
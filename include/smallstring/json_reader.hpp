@@ -0,0 +1,505 @@
+/**
+ * @file json_reader.hpp
+ * @brief Incremental, zero-copy JSON message framing and tokenizing for the
+ *        receive side.
+ *
+ * `smallstring::JsonTokenizer` finds structural characters the way
+ * simdjson's first stage does: each 64-byte block is classified with vector
+ * compares into bitmasks (quotes, backslashes, brackets / colons / commas,
+ * whitespace), backslash-escaped quotes are removed with carry arithmetic,
+ * and a prefix XOR over the quote bits masks out everything inside strings.
+ * What is left are the positions of the structural characters and of the
+ * first byte of every bare scalar.
+ *
+ * Inbound bytes are scanned once, in the order they arrive: a message split
+ * across reads is resumed where the last read ended, with only the final
+ * partial block (under 64 bytes) looked at again.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#include "simd.hpp"
+
+namespace smallstring {
+
+namespace detail {
+
+/// @brief Per-byte classes of one 64-byte block, one bit per byte.
+struct JsonBlock {
+    std::uint64_t quote;
+    std::uint64_t backslash;
+    std::uint64_t op; ///< `{ } [ ] : ,`
+    std::uint64_t whitespace;
+};
+
+#if defined(SMALLSTRING_HAS_NEON)
+/// @brief `_mm_movemask_epi8` for a compare result.
+inline std::uint32_t neon_movemask(uint8x16_t lanes) noexcept {
+    static const std::uint8_t weights[16] = {1, 2, 4, 8, 16, 32, 64, 128,
+                                             1, 2, 4, 8, 16, 32, 64, 128};
+    const uint8x16_t bits = vandq_u8(lanes, vld1q_u8(weights));
+    return vaddv_u8(vget_low_u8(bits)) |
+           (std::uint32_t(vaddv_u8(vget_high_u8(bits))) << 8);
+}
+#endif
+
+inline JsonBlock classify_json_block(const char* ptr) noexcept {
+    JsonBlock block{0, 0, 0, 0};
+#if defined(SMALLSTRING_HAS_AVX2)
+    for (unsigned half = 0; half < 2; half++) {
+        const __m256i v = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(ptr + 32 * half));
+        // '[' | 0x20 == '{' and ']' | 0x20 == '}'.
+        const __m256i folded = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+        const auto mask = [](__m256i m) {
+            return std::uint64_t(
+                static_cast<std::uint32_t>(_mm256_movemask_epi8(m)));
+        };
+        const unsigned shift = 32 * half;
+        block.quote |= mask(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')))
+                       << shift;
+        block.backslash |=
+            mask(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'))) << shift;
+        block.op |=
+            mask(_mm256_or_si256(
+                _mm256_or_si256(
+                    _mm256_cmpeq_epi8(folded, _mm256_set1_epi8('{')),
+                    _mm256_cmpeq_epi8(folded, _mm256_set1_epi8('}'))),
+                _mm256_or_si256(
+                    _mm256_cmpeq_epi8(v, _mm256_set1_epi8(':')),
+                    _mm256_cmpeq_epi8(v, _mm256_set1_epi8(',')))))
+            << shift;
+        block.whitespace |=
+            mask(_mm256_or_si256(
+                _mm256_or_si256(
+                    _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+                    _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t'))),
+                _mm256_or_si256(
+                    _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')),
+                    _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r')))))
+            << shift;
+    }
+#elif defined(SMALLSTRING_HAS_SSE2)
+    for (unsigned quarter = 0; quarter < 4; quarter++) {
+        const __m128i v = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(ptr + 16 * quarter));
+        const __m128i folded = _mm_or_si128(v, _mm_set1_epi8(0x20));
+        const auto mask = [](__m128i m) {
+            return std::uint64_t(
+                static_cast<std::uint32_t>(_mm_movemask_epi8(m)));
+        };
+        const unsigned shift = 16 * quarter;
+        block.quote |= mask(_mm_cmpeq_epi8(v, _mm_set1_epi8('"'))) << shift;
+        block.backslash |= mask(_mm_cmpeq_epi8(v, _mm_set1_epi8('\\')))
+                           << shift;
+        block.op |= mask(_mm_or_si128(
+                        _mm_or_si128(
+                            _mm_cmpeq_epi8(folded, _mm_set1_epi8('{')),
+                            _mm_cmpeq_epi8(folded, _mm_set1_epi8('}'))),
+                        _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(':')),
+                                     _mm_cmpeq_epi8(v, _mm_set1_epi8(',')))))
+                    << shift;
+        block.whitespace |=
+            mask(_mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                             _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+                _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')),
+                             _mm_cmpeq_epi8(v, _mm_set1_epi8('\r')))))
+            << shift;
+    }
+#elif defined(SMALLSTRING_HAS_NEON)
+    for (unsigned quarter = 0; quarter < 4; quarter++) {
+        const uint8x16_t v = vld1q_u8(
+            reinterpret_cast<const std::uint8_t*>(ptr + 16 * quarter));
+        const uint8x16_t folded = vorrq_u8(v, vdupq_n_u8(0x20));
+        const auto eq = [&](uint8x16_t x, char c) {
+            return vceqq_u8(x, vdupq_n_u8(static_cast<std::uint8_t>(c)));
+        };
+        const unsigned shift = 16 * quarter;
+        block.quote |= std::uint64_t(neon_movemask(eq(v, '"'))) << shift;
+        block.backslash |= std::uint64_t(neon_movemask(eq(v, '\\')))
+                           << shift;
+        block.op |= std::uint64_t(neon_movemask(
+                        vorrq_u8(vorrq_u8(eq(folded, '{'), eq(folded, '}')),
+                                 vorrq_u8(eq(v, ':'), eq(v, ',')))))
+                    << shift;
+        block.whitespace |= std::uint64_t(neon_movemask(
+                                vorrq_u8(vorrq_u8(eq(v, ' '), eq(v, '\t')),
+                                         vorrq_u8(eq(v, '\n'), eq(v, '\r')))))
+                            << shift;
+    }
+#else
+    for (unsigned i = 0; i < 64; i++) {
+        const std::uint64_t bit = std::uint64_t(1) << i;
+        switch (ptr[i]) {
+        case '"':
+            block.quote |= bit;
+            break;
+        case '\\':
+            block.backslash |= bit;
+            break;
+        case '{':
+        case '}':
+        case '[':
+        case ']':
+        case ':':
+        case ',':
+            block.op |= bit;
+            break;
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\r':
+            block.whitespace |= bit;
+            break;
+        default:
+            break;
+        }
+    }
+#endif
+    return block;
+}
+
+/// @brief Bit i = XOR of bits 0..i: 1 from an opening quote up to (not
+///        including) its closing quote.
+inline std::uint64_t prefix_xor(std::uint64_t bits) noexcept {
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
+/**
+ * @brief Bytes escaped by a backslash: those right after an odd-length run
+ *        of backslashes.
+ *
+ * @p carry is 1 when the previous block ended in such a run; it is updated
+ * for the next block.  (simdjson's "odd backslash sequences".)
+ */
+inline std::uint64_t escaped_bytes(std::uint64_t backslash,
+                                   std::uint64_t& carry) noexcept {
+    constexpr std::uint64_t even_bits = 0x5555555555555555ULL;
+    constexpr std::uint64_t odd_bits = ~even_bits;
+    if (!backslash) {
+        const std::uint64_t escaped = carry;
+        carry = 0;
+        return escaped;
+    }
+    const std::uint64_t starts = backslash & ~(backslash << 1);
+    const std::uint64_t even_start_mask = even_bits ^ carry;
+    const std::uint64_t even_starts = starts & even_start_mask;
+    const std::uint64_t odd_starts = starts & ~even_start_mask;
+    const std::uint64_t even_carries = backslash + even_starts;
+    std::uint64_t odd_carries = backslash + odd_starts;
+    const bool ends_odd = odd_carries < backslash;
+    odd_carries |= carry;
+    carry = ends_odd ? 1 : 0;
+    const std::uint64_t even_carry_ends = even_carries & ~backslash;
+    const std::uint64_t odd_carry_ends = odd_carries & ~backslash;
+    return (even_carry_ends & odd_bits) | (odd_carry_ends & even_bits);
+}
+
+/// @brief What the walk and the tokenizer need to know about a byte, as
+///        tables so the per-structural work does not branch on it.
+struct JsonByteTable {
+    signed char depth[256] = {};      ///< +1 opens, -1 closes
+    bool whitespace[256] = {};
+    unsigned char token_type[256] = {}; ///< `JsonTokenizer::TokenType`
+
+    constexpr JsonByteTable() {
+        depth[std::uint8_t('{')] = depth[std::uint8_t('[')] = 1;
+        depth[std::uint8_t('}')] = depth[std::uint8_t(']')] = -1;
+        for (const char c : {' ', '\t', '\n', '\r'})
+            whitespace[std::uint8_t(c)] = true;
+        // In `TokenType` order; everything else starts a number.
+        const char types[] = {'{', '}', '[', ']', ':', ',', '"'};
+        for (auto& type : token_type)
+            type = 7;
+        for (unsigned i = 0; i < sizeof(types); i++)
+            token_type[std::uint8_t(types[i])] = static_cast<unsigned char>(i);
+        token_type[std::uint8_t('t')] = 8;
+        token_type[std::uint8_t('f')] = 9;
+        token_type[std::uint8_t('n')] = 10;
+    }
+};
+
+inline constexpr JsonByteTable json_bytes{};
+
+} // namespace detail
+
+/**
+ * @class JsonTokenizer
+ * @brief Frames a stream of JSON objects / arrays and tokenizes each one.
+ *
+ * @code
+ *   smallstring::Buffer<> inbound;
+ *   smallstring::JsonTokenizer json;
+ *   for (;;) {
+ *       inbound.ensure_fit(4096);
+ *       inbound.advance(::read(fd, inbound.tail(), 4096));
+ *       while (const std::size_t n = json.next(inbound.view())) {
+ *           for (const auto& token : json.tokens())
+ *               handle(token.type, token.text); // views into inbound
+ *           inbound.pop(n);
+ *       }
+ *   }
+ * @endcode
+ *
+ * `next(input)` returns the size of the first complete message at the
+ * front of @p input (including whitespace before it), or 0 if more bytes
+ * are needed.  The caller must remove exactly that many bytes from the
+ * front before the next call, and otherwise only append; the tokenizer
+ * remembers how far it has scanned.  Messages may be separated by any
+ * whitespace (NDJSON works as is).
+ *
+ * Token texts are views into the @p input of the call that returned the
+ * message: strings without their quotes and still escaped, scalars as
+ * written.  This is a structural tokenizer, not a validator: malformed
+ * scalars, mismatched bracket kinds and bad escapes are not diagnosed.
+ * A byte other than whitespace, `{` or `[` between messages puts the
+ * tokenizer in an error state until `reset()`.
+ */
+class JsonTokenizer {
+  public:
+    enum class TokenType : char {
+        object_begin,
+        object_end,
+        array_begin,
+        array_end,
+        colon,
+        comma,
+        string,
+        number,
+        true_value,
+        false_value,
+        null_value,
+    };
+    static_assert(static_cast<int>(TokenType::number) == 7 &&
+                      static_cast<int>(TokenType::null_value) == 10,
+                  "detail::JsonByteTable::token_type is out of date");
+
+    struct Token {
+        TokenType type;
+        std::string_view text;
+    };
+
+  private:
+    /// Carries from one block into the next.
+    struct ScanState {
+        std::uint64_t in_string = 0; ///< All ones inside a string
+        std::uint64_t escape = 0;    ///< 1 after an odd backslash run
+        std::uint64_t scalar = 0;    ///< 1 if the last byte was a scalar's
+    };
+
+    /// Where the structural walk is, between calls.
+    struct WalkState {
+        std::size_t index = 0; ///< Next structural to visit
+        std::ptrdiff_t depth = 0;
+        std::size_t first = 0; ///< Index of the message's first structural
+    };
+
+    std::size_t m_origin = 0;  ///< Stream offset of `input[0]`
+    std::size_t m_scanned = 0; ///< Stream offset of the first unscanned byte
+    ScanState m_scan;
+    std::size_t m_tail = 0;    ///< Stream offset scanned up to, tentatively
+    std::vector<std::size_t> m_structurals; ///< Stream offsets, ascending
+    std::size_t m_base = 0;      ///< Structurals before this are consumed
+    std::size_t m_committed = 0; ///< Structurals before this are final
+    WalkState m_walk;
+    std::vector<Token> m_tokens;
+    std::string_view m_message;
+    bool m_error = false;
+
+    /// @brief Classify the 64 bytes at @p ptr (stream offset @p offset)
+    ///        and append the structural positions.
+    void scan_block(const char* ptr, std::size_t offset, ScanState& state) {
+        const detail::JsonBlock block = detail::classify_json_block(ptr);
+        const std::uint64_t escaped =
+            detail::escaped_bytes(block.backslash, state.escape);
+        const std::uint64_t quotes = block.quote & ~escaped;
+        const std::uint64_t in_string =
+            detail::prefix_xor(quotes) ^ state.in_string;
+        state.in_string =
+            static_cast<std::uint64_t>(static_cast<std::int64_t>(in_string) >>
+                                       63);
+        const std::uint64_t outside = ~in_string & ~quotes;
+        const std::uint64_t op = block.op & outside;
+        const std::uint64_t scalar = outside & ~block.op & ~block.whitespace;
+        const std::uint64_t scalar_starts =
+            scalar & ~((scalar << 1) | state.scalar);
+        state.scalar = scalar >> 63;
+        const std::size_t size = m_structurals.size();
+        m_structurals.resize(size + 64);
+        std::size_t* out = m_structurals.data() + size;
+        for (std::uint64_t bits = op | quotes | scalar_starts; bits;
+             bits &= bits - 1)
+            *out++ = offset + detail::count_trailing_zeros(bits);
+        m_structurals.resize(
+            static_cast<std::size_t>(out - m_structurals.data()));
+    }
+
+    /// @brief Scan what @p input has beyond `m_scanned`; whole blocks are
+    ///        committed, the final partial block is tentative.
+    void scan(std::string_view input) {
+        const std::size_t end = m_origin + input.size();
+        if (end == m_tail)
+            return;
+        m_tail = end;
+        m_structurals.resize(m_committed);
+        if (m_base > m_committed / 2) {
+            // Drop the consumed structurals; amortised O(1) each.
+            m_structurals.erase(m_structurals.begin(),
+                                m_structurals.begin() + m_base);
+            m_committed -= m_base;
+            m_walk.index -= m_base;
+            m_walk.first -= std::min(m_walk.first, m_base);
+            m_base = 0;
+        }
+        for (; m_scanned + 64 <= end; m_scanned += 64)
+            scan_block(input.data() + (m_scanned - m_origin), m_scanned,
+                       m_scan);
+        m_committed = m_structurals.size();
+        if (m_scanned < end) {
+            char padded[64];
+            std::memset(padded, ' ', sizeof(padded));
+            std::memcpy(padded, input.data() + (m_scanned - m_origin),
+                        end - m_scanned);
+            ScanState state = m_scan;
+            scan_block(padded, m_scanned, state);
+        }
+    }
+
+    /// @brief Visit structurals from `walk.index` up to @p end; the index
+    ///        of the one closing a message, or `end`.
+    ///
+    /// Only quotes occur between a string's two quotes, so the depth can be
+    /// tracked without knowing which quotes open strings.
+    std::size_t walk(std::string_view input, WalkState& walk,
+                     std::size_t end) {
+        const char* const data = input.data() - m_origin;
+        const std::size_t* const structurals = m_structurals.data();
+        std::ptrdiff_t depth = walk.depth;
+        for (std::size_t i = walk.index; i < end; i++) {
+            const auto c = static_cast<std::uint8_t>(data[structurals[i]]);
+            if (depth == 0) {
+                if (detail::json_bytes.depth[c] <= 0) {
+                    m_error = true;
+                    return end;
+                }
+                walk.first = i;
+            }
+            depth += detail::json_bytes.depth[c];
+            if (depth == 0) {
+                walk.index = i;
+                walk.depth = 0;
+                return i;
+            }
+        }
+        walk.index = end;
+        walk.depth = depth;
+        return end;
+    }
+
+    /// @brief Build `m_tokens` for structurals `[first, last]`.
+    void tokenize(std::string_view input, std::size_t first,
+                  std::size_t last) {
+        // At most one token per structural; sized up front because
+        // `push_back` in this loop costs more than the rest of it.
+        m_tokens.resize(last - first + 1);
+        Token* out = m_tokens.data();
+        const char* const data = input.data() - m_origin;
+        const std::size_t* const structurals = m_structurals.data();
+        for (std::size_t i = first; i <= last; i++) {
+            const std::size_t at = structurals[i];
+            const auto type = static_cast<TokenType>(
+                detail::json_bytes
+                    .token_type[static_cast<std::uint8_t>(data[at])]);
+            std::size_t begin = at, end = at + 1;
+            if (type == TokenType::string) {
+                // The closing quote is the next structural.
+                begin = at + 1;
+                end = structurals[++i];
+            } else if (type >= TokenType::number) {
+                // A scalar runs up to the next structural (a complete
+                // message ends in a bracket), less any whitespace.
+                end = structurals[i + 1];
+                while (detail::json_bytes.whitespace[static_cast<
+                           std::uint8_t>(data[end - 1])])
+                    end--;
+            }
+            *out++ = {type, std::string_view(data + begin, end - begin)};
+        }
+        m_tokens.resize(static_cast<std::size_t>(out - m_tokens.data()));
+    }
+
+  public:
+    JsonTokenizer() = default;
+
+    /**
+     * @brief Scan newly appended bytes and return the size of the first
+     *        complete message in @p input, or 0.
+     *
+     * When a size is returned, `message()` and `tokens()` describe the
+     * message until the next call.
+     */
+    std::size_t next(std::string_view input) {
+        if (m_error)
+            return 0;
+        scan(input);
+        // Progress over final structurals is kept; the tentative ones are
+        // walked from a copy.
+        const std::size_t tentative = m_structurals.size();
+        std::size_t last = walk(input, m_walk, m_committed);
+        WalkState walk_state = m_walk;
+        if (last == m_committed && !m_error)
+            last = walk(input, walk_state, tentative);
+        if (m_error || last == tentative)
+            return 0;
+
+        const std::size_t first = walk_state.first;
+        const std::size_t end = m_structurals[last] + 1;
+        tokenize(input, first, last);
+        const std::size_t start = m_structurals[first] - m_origin;
+        m_message = input.substr(start, end - m_origin - start);
+        const std::size_t consumed = end - m_origin;
+
+        // The caller now drops `consumed` bytes.  If the message ended in
+        // the tentative block, the block can no longer be rescanned from
+        // its start; a message boundary is outside any string, so scanning
+        // restarts there, after what is left of the block is walked.
+        m_base = last + 1;
+        if (end > m_scanned) {
+            m_committed = m_base;
+            m_scanned = end;
+            m_scan = ScanState();
+        }
+        m_walk = WalkState();
+        m_walk.index = m_base;
+        m_origin = end;
+        return consumed;
+    }
+
+    /// @brief The message returned by the last successful `next`.
+    std::string_view message() const { return m_message; }
+
+    /// @brief Its tokens, in order.
+    const std::vector<Token>& tokens() const { return m_tokens; }
+
+    /// @brief Whether a byte outside any message was found.
+    bool error() const { return m_error; }
+
+    /// @brief Forget all state, e.g. after discarding the input.
+    void reset() { *this = JsonTokenizer(); }
+};
+
+} // namespace smallstring
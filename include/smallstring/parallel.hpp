@@ -0,0 +1,291 @@
+/**
+ * @file parallel.hpp
+ * @brief Build one large output on several cores: shards are formatted into
+ *        pooled buffers on a thread pool and stitched back together in
+ *        order.
+ *
+ * @code
+ *   smallstring::ParallelBuilder<> builder; // one thread per core
+ *   builder.build(days.size(), [&](std::size_t i, auto& out) {
+ *       for (const auto& event : days[i].events)
+ *           write_event(out, event);
+ *   });
+ *   builder.concatenate(dump);            // one buffer, parallel memcpy
+ *   // or, without copying:
+ *   const auto iov = builder.iovecs();
+ *   ::writev(fd, iov.data(), static_cast<int>(iov.size()));
+ * @endcode
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if __has_include(<sys/uio.h>)
+#include <sys/uio.h>
+#endif
+
+#include "pool.hpp"
+#include "smallstring.hpp"
+
+namespace smallstring {
+
+namespace detail {
+
+/**
+ * @class TaskPool
+ * @brief Fixed set of worker threads that run `task(i)` for `i` in
+ *        `[0, count)`, with the calling thread taking part.
+ *
+ * `run` blocks until every index has been processed.  The first exception
+ * thrown by a task is rethrown from `run` once all workers are idle.  One
+ * `run` at a time.
+ */
+class TaskPool {
+  private:
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    const std::function<void(std::size_t)>* m_task = nullptr; ///< `m_mutex`
+    std::size_t m_count = 0;                                  ///< `m_mutex`
+    std::size_t m_active = 0;     ///< Workers still in the job; `m_mutex`
+    unsigned long m_generation = 0; ///< Bumped per job; `m_mutex`
+    bool m_stop = false;            ///< `m_mutex`
+    std::exception_ptr m_error;     ///< `m_mutex`
+    std::atomic<std::size_t> m_next{0};
+
+    void drain(const std::function<void(std::size_t)>& task,
+               std::size_t count) {
+        for (std::size_t i; (i = m_next.fetch_add(
+                                 1, std::memory_order_relaxed)) < count;) {
+            try {
+                task(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_error)
+                    m_error = std::current_exception();
+            }
+        }
+    }
+
+    void work() {
+        unsigned long seen = 0;
+        for (;;) {
+            const std::function<void(std::size_t)>* task;
+            std::size_t count;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [&] {
+                    return m_stop || m_generation != seen;
+                });
+                if (m_stop)
+                    return;
+                seen = m_generation;
+                task = m_task;
+                count = m_count;
+            }
+            drain(*task, count);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_active == 0)
+                m_done.notify_one();
+        }
+    }
+
+  public:
+    /// @brief @p threads includes the caller, so `threads - 1` are spawned.
+    explicit TaskPool(unsigned threads) {
+        for (unsigned i = 1; i < threads; i++)
+            m_workers.emplace_back([this] { work(); });
+    }
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    ~TaskPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (auto& worker : m_workers)
+            worker.join();
+    }
+
+    /// @brief Threads that take part in `run`, the caller included.
+    unsigned size() const {
+        return static_cast<unsigned>(m_workers.size()) + 1;
+    }
+
+    void run(std::size_t count, const std::function<void(std::size_t)>& task) {
+        if (m_workers.empty() || count <= 1) {
+            for (std::size_t i = 0; i < count; i++)
+                task(i);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_task = &task;
+            m_count = count;
+            m_active = m_workers.size();
+            m_next.store(0, std::memory_order_relaxed);
+            m_generation++;
+        }
+        m_wake.notify_all();
+        drain(task, count);
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [&] { return m_active == 0; });
+        if (m_error)
+            std::rethrow_exception(std::exchange(m_error, nullptr));
+    }
+};
+
+} // namespace detail
+
+/**
+ * @class ParallelBuilder
+ * @brief Formats independent shards of one output concurrently.
+ *
+ * `build(shards, fn)` calls `fn(i, buffer)` for every shard index on a
+ * persistent thread pool; each shard writes into its own buffer leased from
+ * a `BufferPool`, so repeated builds reuse the same memory.  The shards are
+ * kept in index order and can then be
+ *
+ * * `concatenate`d into one buffer: a prefix sum of the shard lengths gives
+ *   every shard its offset in a single reservation, and the shards are
+ *   copied in parallel; or
+ * * handed to `writev` / `sendmsg` as an ordered `iovecs()` list, with no
+ *   copy at all.
+ *
+ * `fn` runs on several threads at once and must only touch its own shard.
+ * Shards stay valid until `clear()` (or destruction), which returns their
+ * buffers to the pool.  The builder itself is not thread-safe.
+ *
+ * @tparam BufferType Shard buffer type (any `Buffer` instantiation).
+ */
+template <class BufferType = Buffer<>> class ParallelBuilder {
+  private:
+    using Lease = typename BufferPool<BufferType>::Lease;
+
+    BufferPool<BufferType> m_pool;
+    std::vector<Lease> m_shards;
+    detail::TaskPool m_tasks;
+
+    static unsigned default_threads(unsigned threads) {
+        if (threads == 0)
+            threads = std::thread::hardware_concurrency();
+        return threads ? threads : 1;
+    }
+
+  public:
+    /// Outputs smaller than this are concatenated on the calling thread.
+    static constexpr std::size_t parallel_copy_min = 256 * 1024;
+
+    /**
+     * @param threads        Threads to format on, the caller included
+     *                       (0 = one per hardware thread).
+     * @param shard_capacity Initial capacity of each shard buffer.
+     */
+    explicit ParallelBuilder(unsigned threads = 0,
+                             std::size_t shard_capacity = 64 * 1024)
+        : m_pool(shard_capacity,
+                 std::max<std::size_t>(shard_capacity, 64 * 1024) * 16),
+          m_tasks(default_threads(threads)) {}
+
+    ParallelBuilder(const ParallelBuilder&) = delete;
+    ParallelBuilder& operator=(const ParallelBuilder&) = delete;
+
+    ~ParallelBuilder() { clear(); }
+
+    /// @brief Threads used by `build` and `concatenate`.
+    unsigned threads() const { return m_tasks.size(); }
+
+    /**
+     * @brief Append @p shards shards, built by `fn(index, buffer)`.
+     *
+     * Indices run from 0 for the first shard of this call.  If any call
+     * throws, the exception is rethrown here once all shards have run; the
+     * shards are kept either way.
+     */
+    template <class Fn> void build(std::size_t shards, Fn&& fn) {
+        const std::size_t first = m_shards.size();
+        // Leased on this thread, so the pool's free list for this thread
+        // is the one `clear()` refills.
+        for (std::size_t i = 0; i < shards; i++)
+            m_shards.push_back(m_pool.acquire());
+        const std::function<void(std::size_t)> task = [&](std::size_t i) {
+            fn(i, *m_shards[first + i]);
+        };
+        m_tasks.run(shards, task);
+    }
+
+    /// @brief Number of shards built since the last `clear()`.
+    std::size_t shards() const { return m_shards.size(); }
+
+    /// @brief Shard @p index, in build order.
+    const BufferType& shard(std::size_t index) const {
+        return *m_shards[index];
+    }
+
+    /// @brief Total bytes across all shards.
+    std::size_t length() const {
+        std::size_t total = 0;
+        for (const auto& shard : m_shards)
+            total += shard->length();
+        return total;
+    }
+
+    /**
+     * @brief Append every shard, in order, to @p out.
+     *
+     * @p out grows at most once; large outputs are copied by all threads
+     * at once, each shard to the offset given by the lengths before it.
+     */
+    template <class Out> void concatenate(Out& out) {
+        std::vector<std::size_t> offsets(m_shards.size() + 1, 0);
+        for (std::size_t i = 0; i < m_shards.size(); i++)
+            offsets[i + 1] = offsets[i] + m_shards[i]->length();
+        const std::size_t total = offsets.back();
+        out.ensure_fit(total);
+        char* dst = out.tail();
+        const std::function<void(std::size_t)> copy = [&](std::size_t i) {
+            if (const std::size_t n = m_shards[i]->length())
+                std::memcpy(dst + offsets[i], m_shards[i]->head(), n);
+        };
+        if (total < parallel_copy_min) {
+            for (std::size_t i = 0; i < m_shards.size(); i++)
+                copy(i);
+        } else {
+            m_tasks.run(m_shards.size(), copy);
+        }
+        out.advance(total);
+    }
+
+#if __has_include(<sys/uio.h>)
+    /// @brief The non-empty shards as an ordered scatter list for `writev`.
+    std::vector<iovec> iovecs() const {
+        std::vector<iovec> iov;
+        iov.reserve(m_shards.size());
+        for (const auto& shard : m_shards)
+            if (shard->length())
+                iov.push_back({const_cast<char*>(shard->head()),
+                               shard->length()});
+        return iov;
+    }
+#endif
+
+    /// @brief Drop all shards, returning their buffers to the pool.
+    void clear() { m_shards.clear(); }
+};
+
+} // namespace smallstring
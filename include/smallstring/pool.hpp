@@ -0,0 +1,242 @@
+/**
+ * @file pool.hpp
+ * @brief Pool of warmed-up `Buffer`s with per-thread free lists.
+ *
+ * Leasing a buffer from a warm pool is a pop from a thread-local vector; the
+ * shared, mutex-protected overflow list is only touched when a thread's own
+ * list runs dry or overflows.  Returned buffers are `clear()`ed and keep
+ * their capacity unless it grew past the pool's trim threshold.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "smallstring.hpp"
+
+namespace smallstring {
+
+/**
+ * @class BufferPool
+ * @brief Leases out pre-sized buffers through an RAII `Lease` handle.
+ *
+ * Typical usage
+ * @code
+ *   static smallstring::BufferPool<> pool(512);
+ *   auto msg = pool.acquire();
+ *   msg->push("{\"ok\":true}");
+ *   send(msg->view());
+ *   // returned to the calling thread's free list when `msg` goes away
+ * @endcode
+ *
+ * @tparam BufferType A `Buffer` instantiation (needs `clear`, `capacity`,
+ *                    `drop_memory` and `ensure_fit`).
+ *
+ * The pool must outlive its leases.  Buffers cached by a thread that exits
+ * are handed to the shared overflow list.
+ */
+template <class BufferType = Buffer<>> class BufferPool {
+  public:
+    /// @brief Counters since construction (approximate under concurrency).
+    struct Stats {
+        std::size_t hits;   ///< Leases served from a free list
+        std::size_t misses; ///< Leases that had to construct a buffer
+        std::size_t trims;  ///< Returned buffers shrunk back to size
+    };
+
+  private:
+    struct Shared {
+        std::size_t buffer_capacity;
+        std::size_t trim_threshold;
+        std::size_t local_limit;
+
+        std::mutex mutex;
+        std::vector<BufferType> overflow; ///< Guarded by `mutex`
+
+        std::atomic<std::size_t> hits{0};
+        std::atomic<std::size_t> misses{0};
+        std::atomic<std::size_t> trims{0};
+    };
+
+    /// @brief One thread's free list for one pool.
+    struct LocalCache {
+        Shared* key; ///< Identifies the pool without touching `owner`
+        std::weak_ptr<Shared> owner;
+        std::vector<BufferType> free;
+
+        LocalCache(const std::shared_ptr<Shared>& pool)
+            : key(pool.get()), owner(pool) {
+            free.reserve(pool->local_limit);
+        }
+        LocalCache(LocalCache&&) = default;
+        LocalCache& operator=(LocalCache&&) = default;
+
+        ~LocalCache() {
+            if (free.empty())
+                return;
+            if (auto shared = owner.lock()) {
+                std::lock_guard<std::mutex> lock(shared->mutex);
+                for (auto& buffer : free)
+                    shared->overflow.push_back(std::move(buffer));
+            }
+        }
+    };
+
+    std::shared_ptr<Shared> m_shared;
+
+    /// @brief The calling thread's free list for this pool.
+    std::vector<BufferType>& local() {
+        static thread_local std::vector<LocalCache> caches;
+        LocalCache* stale = nullptr;
+        for (auto& cache : caches) {
+            if (cache.key == m_shared.get() && !cache.owner.expired())
+                return cache.free;
+            if (!stale && cache.owner.expired())
+                stale = &cache;
+        }
+        if (stale) {
+            // Left behind by a destroyed pool (possibly at this address).
+            stale->free.clear();
+            stale->key = m_shared.get();
+            stale->owner = m_shared;
+            return stale->free;
+        }
+        return caches.emplace_back(m_shared).free;
+    }
+
+    void release(BufferType&& buffer) {
+        buffer.clear();
+        if (buffer.capacity() > m_shared->trim_threshold) {
+            buffer.drop_memory();
+            buffer.ensure_fit(m_shared->buffer_capacity);
+            m_shared->trims.fetch_add(1, std::memory_order_relaxed);
+        }
+        auto& free = local();
+        if (free.size() < m_shared->local_limit) {
+            free.push_back(std::move(buffer));
+            return;
+        }
+        std::lock_guard<std::mutex> lock(m_shared->mutex);
+        m_shared->overflow.push_back(std::move(buffer));
+    }
+
+  public:
+    /**
+     * @class Lease
+     * @brief Owns a pooled buffer; gives it back to the pool on destruction.
+     */
+    class Lease {
+      private:
+        BufferPool* m_pool;
+        BufferType m_buffer;
+
+        friend class BufferPool;
+        Lease(BufferPool* pool, BufferType&& buffer)
+            : m_pool(pool), m_buffer(std::move(buffer)) {}
+
+      public:
+        Lease(Lease&& other) noexcept
+            : m_pool(std::exchange(other.m_pool, nullptr)),
+              m_buffer(std::move(other.m_buffer)) {}
+
+        Lease& operator=(Lease&& other) noexcept {
+            if (this != &other) {
+                reset();
+                m_pool = std::exchange(other.m_pool, nullptr);
+                m_buffer = std::move(other.m_buffer);
+            }
+            return *this;
+        }
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        ~Lease() { reset(); }
+
+        BufferType& operator*() { return m_buffer; }
+        BufferType* operator->() { return &m_buffer; }
+        const BufferType& operator*() const { return m_buffer; }
+        const BufferType* operator->() const { return &m_buffer; }
+
+        /// @brief Return the buffer to the pool now (the lease becomes empty).
+        void reset() {
+            if (m_pool)
+                std::exchange(m_pool, nullptr)->release(std::move(m_buffer));
+        }
+
+        /// @brief Keep the buffer for good; it will not go back to the pool.
+        BufferType detach() {
+            m_pool = nullptr;
+            return std::move(m_buffer);
+        }
+    };
+
+    /**
+     * @brief Create an empty pool.
+     *
+     * @param buffer_capacity Capacity of newly constructed buffers.
+     * @param trim_threshold  Returned buffers above this capacity are
+     *                        released and re-reserved at @p buffer_capacity.
+     * @param local_limit     Buffers each thread keeps before spilling to
+     *                        the shared overflow list.
+     */
+    explicit BufferPool(std::size_t buffer_capacity = 256,
+                        std::size_t trim_threshold = 64 * 1024,
+                        std::size_t local_limit = 16)
+        : m_shared(std::make_shared<Shared>()) {
+        m_shared->buffer_capacity = buffer_capacity;
+        m_shared->trim_threshold = trim_threshold;
+        m_shared->local_limit = local_limit;
+    }
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    /// @brief Lease an empty buffer, constructing one if none is free.
+    Lease acquire() {
+        auto& free = local();
+        if (!free.empty()) {
+            m_shared->hits.fetch_add(1, std::memory_order_relaxed);
+            Lease lease(this, std::move(free.back()));
+            free.pop_back();
+            return lease;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_shared->mutex);
+            auto& overflow = m_shared->overflow;
+            if (!overflow.empty()) {
+                m_shared->hits.fetch_add(1, std::memory_order_relaxed);
+                Lease lease(this, std::move(overflow.back()));
+                overflow.pop_back();
+                return lease;
+            }
+        }
+        m_shared->misses.fetch_add(1, std::memory_order_relaxed);
+        return Lease(this, BufferType(m_shared->buffer_capacity));
+    }
+
+    /// @brief Take ownership of @p buffer; it joins the pool when the
+    ///        lease ends, like any other.
+    Lease adopt(BufferType&& buffer) { return Lease(this, std::move(buffer)); }
+
+    /// @brief Pre-construct @p count buffers into the shared overflow list.
+    void reserve(std::size_t count) {
+        std::lock_guard<std::mutex> lock(m_shared->mutex);
+        for (std::size_t i = 0; i < count; ++i)
+            m_shared->overflow.emplace_back(m_shared->buffer_capacity);
+    }
+
+    /// @brief Snapshot of the hit / miss / trim counters.
+    Stats stats() const {
+        return {m_shared->hits.load(std::memory_order_relaxed),
+                m_shared->misses.load(std::memory_order_relaxed),
+                m_shared->trims.load(std::memory_order_relaxed)};
+    }
+};
+
+} // namespace smallstring
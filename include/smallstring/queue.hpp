@@ -0,0 +1,233 @@
+/**
+ * @file queue.hpp
+ * @brief Bounded lock-free hand-off of whole `Buffer`s between threads.
+ *
+ * Both queues own a fixed ring of pre-constructed buffers.  A producer
+ * *swaps* its filled buffer into a free slot and gets back the buffer that
+ * slot last held – already drained and `clear()`ed by the consumer, with its
+ * capacity intact.  In steady state nothing is allocated, freed or copied:
+ * only `Buffer` move operations run.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <utility>
+
+#include "smallstring.hpp"
+
+namespace smallstring {
+
+namespace detail {
+
+inline constexpr std::size_t queue_cache_line = 64;
+
+/// @brief Smallest power of two ≥ @p n (and ≥ 1).
+inline std::size_t round_up_pow2(std::size_t n) {
+    std::size_t rounded = 1;
+    while (rounded < n)
+        rounded *= 2;
+    return rounded;
+}
+
+} // namespace detail
+
+/**
+ * @class SpscBufferQueue
+ * @brief Single-producer / single-consumer queue of recycled buffers.
+ *
+ * Typical usage
+ * @code
+ *   smallstring::SpscBufferQueue<> queue(64);
+ *   smallstring::Buffer<> msg;
+ *   // worker thread
+ *   msg.push("...");
+ *   queue.push(msg);        // msg now holds an empty, warmed-up buffer
+ *   // I/O thread
+ *   while (auto* ready = queue.front()) {
+ *       send(ready->view());
+ *       queue.pop();        // clears it and hands it back to the producer
+ *   }
+ * @endcode
+ *
+ * @tparam BufferType Any movable type with `clear()`, normally a `Buffer`.
+ */
+template <class BufferType = Buffer<>> class SpscBufferQueue {
+  private:
+    struct alignas(detail::queue_cache_line) Slot {
+        BufferType buffer;
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    std::size_t m_mask;
+
+    alignas(detail::queue_cache_line) std::atomic<std::size_t> m_head{0};
+    std::size_t m_cached_tail = 0; ///< Consumer's copy of `m_tail`
+    alignas(detail::queue_cache_line) std::atomic<std::size_t> m_tail{0};
+    std::size_t m_cached_head = 0; ///< Producer's copy of `m_head`
+
+  public:
+    /**
+     * @brief Create a queue of at least @p slots buffers.
+     *
+     * @p slots is rounded up to a power of two; every slot starts with a
+     * `BufferType(buffer_capacity)`.
+     */
+    explicit SpscBufferQueue(std::size_t slots,
+                             std::size_t buffer_capacity = 256)
+        : m_slots(new Slot[detail::round_up_pow2(slots)]),
+          m_mask(detail::round_up_pow2(slots) - 1) {
+        for (std::size_t i = 0; i <= m_mask; ++i)
+            m_slots[i].buffer = BufferType(buffer_capacity);
+    }
+
+    SpscBufferQueue(const SpscBufferQueue&) = delete;
+    SpscBufferQueue& operator=(const SpscBufferQueue&) = delete;
+
+    /// @brief Number of slots.
+    std::size_t capacity() const { return m_mask + 1; }
+
+    /* --------------------------------------------------------------------- */
+    /*                             Producer side                             */
+    /* --------------------------------------------------------------------- */
+
+    /**
+     * @brief Hand @p buffer to the consumer if a slot is free.
+     *
+     * On success @p buffer is swapped with the slot's previous (empty)
+     * buffer.  On failure @p buffer is untouched.
+     */
+    bool try_push(BufferType& buffer) {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cached_head == capacity()) {
+            m_cached_head = m_head.load(std::memory_order_acquire);
+            if (tail - m_cached_head == capacity())
+                return false;
+        }
+        using std::swap;
+        swap(m_slots[tail & m_mask].buffer, buffer);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief `try_push`, yielding until a slot is free.
+    void push(BufferType& buffer) {
+        while (!try_push(buffer))
+            std::this_thread::yield();
+    }
+
+    /* --------------------------------------------------------------------- */
+    /*                             Consumer side                             */
+    /* --------------------------------------------------------------------- */
+
+    /// @brief Oldest filled buffer, or `nullptr` if the queue is empty.
+    BufferType* front() {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cached_tail) {
+            m_cached_tail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cached_tail)
+                return nullptr;
+        }
+        return &m_slots[head & m_mask].buffer;
+    }
+
+    /// @brief `clear()` the buffer returned by `front()` and recycle it.
+    void pop() {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        m_slots[head & m_mask].buffer.clear();
+        m_head.store(head + 1, std::memory_order_release);
+    }
+};
+
+/**
+ * @class MpscBufferQueue
+ * @brief Multi-producer / single-consumer variant of `SpscBufferQueue`.
+ *
+ * Same swap-and-recycle interface; producers claim slots with a CAS and a
+ * per-slot sequence number (Vyukov's bounded queue), so `try_push` may be
+ * called from any number of threads.  `front()` / `pop()` must stay on one
+ * thread.
+ */
+template <class BufferType = Buffer<>> class MpscBufferQueue {
+  private:
+    struct alignas(detail::queue_cache_line) Slot {
+        std::atomic<std::size_t> sequence{0};
+        BufferType buffer;
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    std::size_t m_mask;
+
+    alignas(detail::queue_cache_line) std::atomic<std::size_t> m_tail{0};
+    alignas(detail::queue_cache_line) std::size_t m_head = 0;
+
+  public:
+    /// @copydoc SpscBufferQueue::SpscBufferQueue
+    explicit MpscBufferQueue(std::size_t slots,
+                             std::size_t buffer_capacity = 256)
+        : m_slots(new Slot[detail::round_up_pow2(slots)]),
+          m_mask(detail::round_up_pow2(slots) - 1) {
+        for (std::size_t i = 0; i <= m_mask; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+            m_slots[i].buffer = BufferType(buffer_capacity);
+        }
+    }
+
+    MpscBufferQueue(const MpscBufferQueue&) = delete;
+    MpscBufferQueue& operator=(const MpscBufferQueue&) = delete;
+
+    /// @brief Number of slots.
+    std::size_t capacity() const { return m_mask + 1; }
+
+    /// @copydoc SpscBufferQueue::try_push
+    bool try_push(BufferType& buffer) {
+        std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &m_slots[tail & m_mask];
+            const std::size_t sequence =
+                slot->sequence.load(std::memory_order_acquire);
+            const auto lag = static_cast<std::ptrdiff_t>(sequence - tail);
+            if (lag == 0) {
+                if (m_tail.compare_exchange_weak(tail, tail + 1,
+                                                 std::memory_order_relaxed))
+                    break;
+            } else if (lag < 0) {
+                return false; // full
+            } else {
+                tail = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+        using std::swap;
+        swap(slot->buffer, buffer);
+        slot->sequence.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief `try_push`, yielding until a slot is free.
+    void push(BufferType& buffer) {
+        while (!try_push(buffer))
+            std::this_thread::yield();
+    }
+
+    /// @copydoc SpscBufferQueue::front
+    BufferType* front() {
+        Slot& slot = m_slots[m_head & m_mask];
+        if (slot.sequence.load(std::memory_order_acquire) != m_head + 1)
+            return nullptr;
+        return &slot.buffer;
+    }
+
+    /// @copydoc SpscBufferQueue::pop
+    void pop() {
+        Slot& slot = m_slots[m_head & m_mask];
+        slot.buffer.clear();
+        slot.sequence.store(m_head + capacity(), std::memory_order_release);
+        ++m_head;
+    }
+};
+
+} // namespace smallstring
@@ -0,0 +1,163 @@
+/**
+ * @file realloc.hpp
+ * @brief Buffer growth that extends memory in place instead of copying.
+ *
+ * `std::vector` grows by allocating a new block, copying and freeing the
+ * old one, so every doubling of a large buffer copies all of it.
+ * `ReallocAllocator` gives `ReallocStorage` a `reallocate` built on
+ * `std::realloc`, which extends a block in place when the heap has room
+ * behind it, and – on Linux, for blocks of at least a threshold – on
+ * `mmap` / `mremap`, which moves page table entries rather than bytes.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdlib> // std::malloc, std::realloc, std::free
+#include <cstring>
+#include <new> // std::bad_alloc
+#include <type_traits>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "smallstring.hpp"
+
+namespace smallstring {
+
+/**
+ * @class ReallocAllocator
+ * @brief STL allocator for trivially copyable @p T with a `reallocate`
+ *        that avoids copying where the platform allows.
+ *
+ * Blocks smaller than @p MapThreshold bytes come from `std::malloc` and
+ * grow with `std::realloc`.  On Linux, blocks of @p MapThreshold bytes or
+ * more are whole-page anonymous mappings of their own and grow with
+ * `mremap`: glibc would map such blocks too, but only up to its adaptive
+ * mmap threshold, above which `realloc` in the main heap usually copies.
+ * Elsewhere every block goes through `std::realloc`.
+ *
+ * @code
+ *   smallstring::ReallocBuffer<> snapshot;
+ *   // ... tens of MB of pushes, none of which copy the contents ...
+ * @endcode
+ */
+template <class T, std::size_t MapThreshold = 256 * 1024>
+class ReallocAllocator {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "ReallocAllocator moves elements as bytes");
+
+  public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    template <class U> using rebound = ReallocAllocator<U, MapThreshold>;
+
+    template <class U> struct rebind {
+        using other = rebound<U>;
+    };
+
+    ReallocAllocator() = default;
+
+    template <class U> ReallocAllocator(const rebound<U>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        const std::size_t bytes = size_in_bytes(n);
+#if defined(__linux__)
+        if (bytes >= MapThreshold) {
+            void* ptr = ::mmap(nullptr, page_round(bytes),
+                               PROT_READ | PROT_WRITE,
+                               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (ptr == MAP_FAILED)
+                throw std::bad_alloc();
+            return static_cast<T*>(ptr);
+        }
+#endif
+        void* ptr = std::malloc(bytes ? bytes : 1);
+        if (!ptr)
+            throw std::bad_alloc();
+        return static_cast<T*>(ptr);
+    }
+
+    void deallocate(T* ptr, std::size_t n) noexcept {
+#if defined(__linux__)
+        if (n * sizeof(T) >= MapThreshold) {
+            ::munmap(ptr, page_round(n * sizeof(T)));
+            return;
+        }
+#else
+        (void)n;
+#endif
+        std::free(ptr);
+    }
+
+    /**
+     * @brief Resize @p ptr from @p old_n to @p new_n elements, keeping the
+     *        first @p used; @p ptr is left intact if this throws.
+     *
+     * Only a step across @p MapThreshold copies (the @p used elements).
+     */
+    T* reallocate(T* ptr, std::size_t old_n, std::size_t new_n,
+                  std::size_t used) {
+        const std::size_t new_bytes = size_in_bytes(new_n);
+#if defined(__linux__)
+        const std::size_t old_bytes = old_n * sizeof(T);
+        const bool old_mapped = old_bytes >= MapThreshold;
+        const bool new_mapped = new_bytes >= MapThreshold;
+        if (old_mapped && new_mapped) {
+            void* moved = ::mremap(ptr, page_round(old_bytes),
+                                   page_round(new_bytes), MREMAP_MAYMOVE);
+            if (moved == MAP_FAILED)
+                throw std::bad_alloc();
+            return static_cast<T*>(moved);
+        }
+        if (old_mapped || new_mapped) {
+            T* fresh = allocate(new_n);
+            std::memcpy(fresh, ptr, used * sizeof(T));
+            deallocate(ptr, old_n);
+            return fresh;
+        }
+#else
+        (void)old_n;
+        (void)used;
+#endif
+        void* grown = std::realloc(ptr, new_bytes ? new_bytes : 1);
+        if (!grown)
+            throw std::bad_alloc();
+        return static_cast<T*>(grown);
+    }
+
+    template <class U> bool operator==(const rebound<U>&) const noexcept {
+        return true;
+    }
+
+    template <class U> bool operator!=(const rebound<U>&) const noexcept {
+        return false;
+    }
+
+  private:
+    static std::size_t size_in_bytes(std::size_t n) {
+        if (n > ~std::size_t(0) / sizeof(T) / 2)
+            throw std::bad_alloc();
+        return n * sizeof(T);
+    }
+
+#if defined(__linux__)
+    static std::size_t page_round(std::size_t bytes) noexcept {
+        static const auto page =
+            static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        return (bytes + page - 1) & ~(page - 1);
+    }
+#endif
+};
+
+/// @brief A `Buffer` that grows with `realloc` / `mremap` rather than
+///        allocate-copy-free.
+template <class Growth = DoublingGrowth, class Stats = NoStats>
+using ReallocBuffer =
+    Buffer<ReallocAllocator<char>, Growth,
+           ReallocStorage<ReallocAllocator<char>>, Stats>;
+
+} // namespace smallstring
@@ -0,0 +1,222 @@
+/**
+ * @file ring_buffer.hpp
+ * @brief Mirrored (virtual-memory) ring buffer with the `Buffer` push API.
+ *
+ * The same physical pages are mapped twice, back-to-back, so any window of
+ * up to `capacity()` bytes starting anywhere in the ring is contiguous in
+ * virtual memory.  Pushes therefore never wrap and the unread region is
+ * always a single `std::string_view` – nothing is ever memmoved.
+ *
+ * Linux only (`memfd_create` + `mmap`).
+ */
+
+#pragma once
+
+#if defined(__linux__)
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "smallstring.hpp"
+
+namespace smallstring {
+
+/**
+ * @class RingBuffer
+ * @brief Fixed-capacity byte queue for one producer and one consumer.
+ *
+ * The producer builds messages with the usual `push` overloads and makes
+ * them visible with `publish()`; the consumer reads `view()` and releases
+ * bytes with `pop()`.  Producer and consumer may be different threads.
+ *
+ * Typical usage
+ * @code
+ *   smallstring::RingBuffer ring(1 << 20);
+ *   // producer thread
+ *   ring.push("{\"seq\":");
+ *   ring.push(seq);
+ *   ring.push("}\n");
+ *   ring.publish();
+ *   // writer thread
+ *   auto pending = ring.view();
+ *   ring.pop(::write(fd, pending.data(), pending.size()));
+ * @endcode
+ *
+ * The capacity is rounded up to a power of two no smaller than a page.
+ * When a push does not fit, the producer waits for the consumer to `pop`;
+ * use `space()` to check first if both sides run on the same thread.
+ */
+class RingBuffer : public PushInterface<RingBuffer> {
+  private:
+    static constexpr std::size_t cache_line = 64;
+
+    char* m_data = nullptr;   ///< Start of the 2 x capacity mapping
+    std::size_t m_mask = 0;   ///< capacity - 1
+    std::size_t m_write = 0;  ///< Producer position, including unpublished
+    alignas(cache_line) std::atomic<std::size_t> m_published{0};
+    alignas(cache_line) std::atomic<std::size_t> m_consumed{0};
+
+    static std::size_t round_capacity(std::size_t capacity) {
+        std::size_t rounded = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        while (rounded < capacity)
+            rounded *= 2;
+        return rounded;
+    }
+
+    [[noreturn]] static void fail(const char* what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+  public:
+    /// @brief Map a ring of at least @p capacity bytes.
+    ///
+    /// @throws std::system_error if the mapping cannot be created.
+    explicit RingBuffer(std::size_t capacity = 1 << 16) {
+        const std::size_t size = round_capacity(capacity);
+        const int fd = memfd_create("smallstring-ring", MFD_CLOEXEC);
+        if (fd < 0)
+            fail("memfd_create");
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            close(fd);
+            fail("ftruncate");
+        }
+        // Reserve 2 x size of address space, then map the file into both
+        // halves.
+        void* base = mmap(nullptr, 2 * size, PROT_NONE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED) {
+            close(fd);
+            fail("mmap");
+        }
+        char* data = static_cast<char*>(base);
+        for (char* half : {data, data + size}) {
+            if (mmap(half, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED,
+                     fd, 0) == MAP_FAILED) {
+                munmap(base, 2 * size);
+                close(fd);
+                fail("mmap");
+            }
+        }
+        close(fd);
+        m_data = data;
+        m_mask = size - 1;
+    }
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    ~RingBuffer() { munmap(m_data, 2 * capacity()); }
+
+    /* --------------------------------------------------------------------- */
+    /*                              Capacity API                             */
+    /* --------------------------------------------------------------------- */
+
+    /// @brief Total bytes the ring can hold.
+    std::size_t capacity() const { return m_mask + 1; }
+
+    /// @brief Published bytes not yet popped (consumer side).
+    std::size_t length() const {
+        return m_published.load(std::memory_order_acquire) -
+               m_consumed.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Bytes the producer can push without waiting.
+    std::size_t space() const {
+        return capacity() -
+               (m_write - m_consumed.load(std::memory_order_acquire));
+    }
+
+    /* --------------------------------------------------------------------- */
+    /*                             Producer side                             */
+    /* --------------------------------------------------------------------- */
+
+    /**
+     * @brief Make @p to_add contiguous bytes writable at `tail()`.
+     *
+     * Waits (yielding) until the consumer has freed enough space.  Bytes
+     * pushed since the last `publish()` are invisible to the consumer, so
+     * they count against the capacity: waiting could never free them.
+     *
+     * @throws std::length_error if the unpublished bytes plus @p to_add
+     *         exceed `capacity()`.
+     */
+    void ensure_fit(std::size_t to_add) {
+        const std::size_t unpublished =
+            m_write - m_published.load(std::memory_order_relaxed);
+        if (to_add > capacity() - unpublished)
+            throw std::length_error("RingBuffer: push larger than capacity");
+        while (space() < to_add)
+            std::this_thread::yield();
+    }
+
+    /// @brief Where the next pushed byte goes.
+    char* tail() { return m_data + (m_write & m_mask); }
+
+    /// @brief Mark @p n bytes written at `tail()` as used (not yet visible).
+    void advance(std::size_t n) { m_write += n; }
+
+    /// @brief Make everything pushed so far visible to the consumer.
+    void publish() { m_published.store(m_write, std::memory_order_release); }
+
+    /// @brief Drop everything pushed since the last `publish()`.
+    void discard() { m_write = m_published.load(std::memory_order_relaxed); }
+
+    /* --------------------------------------------------------------------- */
+    /*                             Consumer side                             */
+    /* --------------------------------------------------------------------- */
+
+    /// @brief First published, unpopped byte.
+    const char* head() const {
+        return m_data + (m_consumed.load(std::memory_order_relaxed) & m_mask);
+    }
+
+    /// @brief All published, unpopped bytes as one contiguous view.
+    [[nodiscard]] std::string_view view() const {
+        return std::string_view(head(), length());
+    }
+
+    /// @brief Release the first @p n bytes (capped at `length()`) in O(1).
+    void pop(std::size_t n) {
+        const std::size_t available = length();
+        m_consumed.store(m_consumed.load(std::memory_order_relaxed) +
+                             (n < available ? n : available),
+                         std::memory_order_release);
+    }
+
+    /// @brief Offset of the first occurrence of @p str at or after @p pos,
+    ///        or `npos`; same result as `std::string_view::find`, but
+    ///        vectorised (see search.hpp).
+    std::size_t find(std::string_view str, std::size_t pos = 0UL) const {
+        return detail::find_in(view(), str, pos);
+    }
+
+    /// @brief Offset of the first @p ch at or after @p pos, or `npos`.
+    std::size_t find_byte(char ch, std::size_t pos = 0UL) const {
+        return detail::find_byte_in(view(), ch, pos);
+    }
+
+    /// @brief Offset of the first byte in @p set at or after @p pos, or
+    ///        `npos`.
+    std::size_t find_any_of(const ByteSet& set, std::size_t pos = 0UL) const {
+        return detail::find_any_of_in(view(), set, pos);
+    }
+
+    /// @brief `find_any_of` for a one-off set; prefer a reused `ByteSet`.
+    std::size_t find_any_of(std::string_view set,
+                            std::size_t pos = 0UL) const {
+        return find_any_of(ByteSet(set), pos);
+    }
+};
+
+} // namespace smallstring
+
+#endif // defined(__linux__)
@@ -0,0 +1,370 @@
+/**
+ * @file search.hpp
+ * @brief Vectorised byte, substring and byte-set search behind
+ *        `Buffer::find`, `find_byte` and `find_any_of`, and byte-string
+ *        comparison.
+ *
+ * * Single bytes go to `memchr`, which every mainstream C library already
+ *   vectorises.
+ * * Substrings jump between occurrences of the needle's first byte with
+ *   `memchr` while that byte is rare.  Once it proves common they switch
+ *   to a two-byte anchor filter: a block is compared against the needle's
+ *   first and last bytes at the matching offsets, and only the positions
+ *   where both agree are verified with `memcmp`.
+ * * Small byte sets (up to `ByteSet::simd_limit` members) are OR-ed
+ *   compares per block; larger sets fall back to a 256-bit lookup table.
+ * * Equality and ordering (`operator==`, `compare`) look for the first
+ *   mismatching block.
+ *
+ * All functions return @p n when nothing is found.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "simd.hpp"
+
+namespace smallstring {
+
+/**
+ * @class ByteSet
+ * @brief A set of bytes to search for with `find_any_of`.
+ *
+ * Build it once and reuse it when the same delimiters are scanned for
+ * repeatedly.
+ */
+class ByteSet {
+  public:
+    /// Sets up to this size are matched with vector compares.
+    static constexpr std::size_t simd_limit = 8;
+
+    constexpr ByteSet() = default;
+
+    constexpr ByteSet(std::string_view bytes) {
+        for (const char ch : bytes)
+            insert(ch);
+    }
+
+    constexpr void insert(char ch) {
+        const auto byte = static_cast<unsigned char>(ch);
+        if (contains(ch))
+            return;
+        m_bits[byte / 64] |= std::uint64_t(1) << (byte % 64);
+        if (m_count < simd_limit)
+            m_members[m_count] = ch;
+        m_count++;
+    }
+
+    constexpr bool contains(char ch) const {
+        const auto byte = static_cast<unsigned char>(ch);
+        return (m_bits[byte / 64] >> (byte % 64)) & 1;
+    }
+
+    constexpr std::size_t size() const { return m_count; }
+
+    /// @brief The members, valid while `size() <= simd_limit`.
+    constexpr const char* members() const { return m_members; }
+
+  private:
+    std::uint64_t m_bits[4] = {};
+    char m_members[simd_limit] = {};
+    std::size_t m_count = 0;
+};
+
+namespace detail {
+
+/// @brief Index of the first @p ch in `[ptr, ptr + n)`, or n.
+inline std::size_t find_byte(const char* ptr, std::size_t n,
+                             char ch) noexcept {
+    if (n == 0)
+        return 0;
+    const void* hit = std::memchr(ptr, ch, n);
+    return hit ? static_cast<const char*>(hit) - ptr : n;
+}
+
+/// @brief Byte-at-a-time `find_any_of`, used for tails and large sets.
+inline std::size_t find_any_of_scalar(const char* ptr, std::size_t n,
+                                      const ByteSet& set) noexcept {
+    std::size_t i = 0;
+    while (i < n && !set.contains(ptr[i]))
+        ++i;
+    return i;
+}
+
+/// @brief Index of the first byte of `[ptr, ptr + n)` in @p set, or n.
+inline std::size_t find_any_of(const char* ptr, std::size_t n,
+                               const ByteSet& set) noexcept {
+    const std::size_t count = set.size();
+    if (count == 0)
+        return n;
+    if (count == 1)
+        return find_byte(ptr, n, set.members()[0]);
+    std::size_t i = 0;
+    if (count <= ByteSet::simd_limit) {
+#if defined(SMALLSTRING_HAS_AVX2)
+        __m256i members[ByteSet::simd_limit];
+        for (std::size_t k = 0; k < count; k++)
+            members[k] = _mm256_set1_epi8(set.members()[k]);
+        for (; i + 32 <= n; i += 32) {
+            const __m256i v = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(ptr + i));
+            __m256i hits = _mm256_cmpeq_epi8(v, members[0]);
+            for (std::size_t k = 1; k < count; k++)
+                hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(v, members[k]));
+            const auto mask =
+                static_cast<std::uint32_t>(_mm256_movemask_epi8(hits));
+            if (mask)
+                return i + count_trailing_zeros(mask);
+        }
+#endif
+#if defined(SMALLSTRING_HAS_SSE2)
+        __m128i members16[ByteSet::simd_limit];
+        for (std::size_t k = 0; k < count; k++)
+            members16[k] = _mm_set1_epi8(set.members()[k]);
+        for (; i + 16 <= n; i += 16) {
+            const __m128i v =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr + i));
+            __m128i hits = _mm_cmpeq_epi8(v, members16[0]);
+            for (std::size_t k = 1; k < count; k++)
+                hits = _mm_or_si128(hits, _mm_cmpeq_epi8(v, members16[k]));
+            const auto mask =
+                static_cast<std::uint32_t>(_mm_movemask_epi8(hits));
+            if (mask)
+                return i + count_trailing_zeros(mask);
+        }
+#elif defined(SMALLSTRING_HAS_NEON)
+        uint8x16_t members16[ByteSet::simd_limit];
+        for (std::size_t k = 0; k < count; k++)
+            members16[k] =
+                vdupq_n_u8(static_cast<std::uint8_t>(set.members()[k]));
+        for (; i + 16 <= n; i += 16) {
+            const uint8x16_t v =
+                vld1q_u8(reinterpret_cast<const std::uint8_t*>(ptr + i));
+            uint8x16_t hits = vceqq_u8(v, members16[0]);
+            for (std::size_t k = 1; k < count; k++)
+                hits = vorrq_u8(hits, vceqq_u8(v, members16[k]));
+            const std::uint64_t mask = neon_nibble_mask(hits);
+            if (mask)
+                return i + count_trailing_zeros(mask) / 4;
+        }
+#endif
+    }
+    return i + find_any_of_scalar(ptr + i, n - i, set);
+}
+
+/// @brief Scalar substring search: `memchr` to the first byte, then
+///        check the last byte before comparing the rest.
+inline std::size_t find_substring_scalar(const char* ptr, std::size_t n,
+                                         const char* needle,
+                                         std::size_t m) noexcept {
+    std::size_t i = 0;
+    while (i + m <= n) {
+        i += find_byte(ptr + i, n - m + 1 - i, needle[0]);
+        if (i + m > n)
+            break;
+        if (ptr[i + m - 1] == needle[m - 1] &&
+            std::memcmp(ptr + i + 1, needle + 1, m - 1) == 0)
+            return i;
+        ++i;
+    }
+    return n;
+}
+
+/// @brief Index of the first occurrence of `[needle, needle + m)`, or n.
+inline std::size_t find_substring(const char* ptr, std::size_t n,
+                                  const char* needle,
+                                  std::size_t m) noexcept {
+    if (m == 0)
+        return 0;
+    if (m > n)
+        return n;
+    if (m == 1)
+        return find_byte(ptr, n, needle[0]);
+    const std::size_t last = m - 1;
+    std::size_t i = 0;
+    // While the first byte is rare, jumping between its occurrences with
+    // memchr is fastest; once it turns out to be common, switch to the
+    // anchor filter.
+    for (std::size_t misses = 0; i + m <= n;) {
+        i += find_byte(ptr + i, n - last - i, needle[0]);
+        if (i + m > n)
+            return n;
+        if (ptr[i + last] == needle[last] &&
+            std::memcmp(ptr + i + 1, needle + 1, m - 2) == 0)
+            return i;
+        ++i;
+        if (++misses >= 16 && misses * 64 > i)
+            break;
+    }
+    // Candidate i needs ptr[i] == first and ptr[i + m - 1] == last; the
+    // middle bytes are only compared for candidates.
+#if defined(SMALLSTRING_HAS_AVX2)
+    {
+        const __m256i first_bytes = _mm256_set1_epi8(needle[0]);
+        const __m256i last_bytes = _mm256_set1_epi8(needle[last]);
+        for (; i + last + 32 <= n; i += 32) {
+            const __m256i head = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(ptr + i));
+            const __m256i tail = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(ptr + i + last));
+            auto mask = static_cast<std::uint32_t>(
+                _mm256_movemask_epi8(_mm256_and_si256(
+                    _mm256_cmpeq_epi8(head, first_bytes),
+                    _mm256_cmpeq_epi8(tail, last_bytes))));
+            while (mask) {
+                const std::size_t at = i + count_trailing_zeros(mask);
+                if (std::memcmp(ptr + at + 1, needle + 1, m - 2) == 0)
+                    return at;
+                mask &= mask - 1;
+            }
+        }
+    }
+#endif
+#if defined(SMALLSTRING_HAS_SSE2)
+    {
+        const __m128i first_bytes = _mm_set1_epi8(needle[0]);
+        const __m128i last_bytes = _mm_set1_epi8(needle[last]);
+        for (; i + last + 16 <= n; i += 16) {
+            const __m128i head =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr + i));
+            const __m128i tail = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(ptr + i + last));
+            auto mask = static_cast<std::uint32_t>(
+                _mm_movemask_epi8(_mm_and_si128(
+                    _mm_cmpeq_epi8(head, first_bytes),
+                    _mm_cmpeq_epi8(tail, last_bytes))));
+            while (mask) {
+                const std::size_t at = i + count_trailing_zeros(mask);
+                if (std::memcmp(ptr + at + 1, needle + 1, m - 2) == 0)
+                    return at;
+                mask &= mask - 1;
+            }
+        }
+    }
+#elif defined(SMALLSTRING_HAS_NEON)
+    {
+        const uint8x16_t first_bytes =
+            vdupq_n_u8(static_cast<std::uint8_t>(needle[0]));
+        const uint8x16_t last_bytes =
+            vdupq_n_u8(static_cast<std::uint8_t>(needle[last]));
+        for (; i + last + 16 <= n; i += 16) {
+            const uint8x16_t head =
+                vld1q_u8(reinterpret_cast<const std::uint8_t*>(ptr + i));
+            const uint8x16_t tail = vld1q_u8(
+                reinterpret_cast<const std::uint8_t*>(ptr + i + last));
+            std::uint64_t mask = neon_nibble_mask(vandq_u8(
+                vceqq_u8(head, first_bytes), vceqq_u8(tail, last_bytes)));
+            while (mask) {
+                const unsigned bit = count_trailing_zeros(mask);
+                const std::size_t at = i + bit / 4;
+                if (std::memcmp(ptr + at + 1, needle + 1, m - 2) == 0)
+                    return at;
+                mask &= ~(std::uint64_t(0xF) << (bit & ~3U));
+            }
+        }
+    }
+#endif
+    return i + find_substring_scalar(ptr + i, n - i, needle, m);
+}
+
+/// @brief Index of the first byte where `[a, a + n)` and `[b, b + n)`
+///        differ, or n.
+inline std::size_t find_mismatch(const char* a, const char* b,
+                                 std::size_t n) noexcept {
+    std::size_t i = 0;
+#if defined(SMALLSTRING_HAS_AVX2)
+    for (; i + 32 <= n; i += 32) {
+        const __m256i x =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        const __m256i y =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        const auto same =
+            static_cast<std::uint32_t>(_mm256_movemask_epi8(
+                _mm256_cmpeq_epi8(x, y)));
+        if (same != 0xFFFFFFFFU)
+            return i + count_trailing_zeros(~same);
+    }
+#endif
+#if defined(SMALLSTRING_HAS_SSE2)
+    for (; i + 16 <= n; i += 16) {
+        const __m128i x =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        const __m128i y =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        const auto same = static_cast<std::uint32_t>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(x, y)));
+        if (same != 0xFFFFU)
+            return i + count_trailing_zeros(~same);
+    }
+#elif defined(SMALLSTRING_HAS_NEON)
+    for (; i + 16 <= n; i += 16) {
+        const uint8x16_t x =
+            vld1q_u8(reinterpret_cast<const std::uint8_t*>(a + i));
+        const uint8x16_t y =
+            vld1q_u8(reinterpret_cast<const std::uint8_t*>(b + i));
+        const std::uint64_t differ = neon_nibble_mask(vmvnq_u8(vceqq_u8(x, y)));
+        if (differ)
+            return i + count_trailing_zeros(differ) / 4;
+    }
+#endif
+    for (std::uint64_t x, y; i + 8 <= n; i += 8) {
+        std::memcpy(&x, a + i, 8);
+        std::memcpy(&y, b + i, 8);
+        if (x != y)
+            break;
+    }
+    while (i < n && a[i] == b[i])
+        ++i;
+    return i;
+}
+
+/// @brief `std::string_view::compare` semantics (bytes compared as
+///        unsigned), via `find_mismatch`.
+inline int compare_bytes(std::string_view a, std::string_view b) noexcept {
+    const std::size_t common = a.size() < b.size() ? a.size() : b.size();
+    const std::size_t at = find_mismatch(a.data(), b.data(), common);
+    if (at < common)
+        return static_cast<unsigned char>(a[at]) <
+                       static_cast<unsigned char>(b[at])
+                   ? -1
+                   : 1;
+    return a.size() < b.size() ? -1 : a.size() > b.size() ? 1 : 0;
+}
+
+/* ---- std::string_view-style wrappers (position in, npos out) ---------- */
+
+inline std::size_t find_in(std::string_view haystack, std::string_view needle,
+                           std::size_t pos) noexcept {
+    if (pos > haystack.size())
+        return std::string_view::npos;
+    const std::size_t rest = haystack.size() - pos;
+    const std::size_t at = find_substring(haystack.data() + pos, rest,
+                                          needle.data(), needle.size());
+    return at == rest && !needle.empty() ? std::string_view::npos : pos + at;
+}
+
+inline std::size_t find_byte_in(std::string_view haystack, char ch,
+                                std::size_t pos) noexcept {
+    if (pos >= haystack.size())
+        return std::string_view::npos;
+    const std::size_t rest = haystack.size() - pos;
+    const std::size_t at = find_byte(haystack.data() + pos, rest, ch);
+    return at == rest ? std::string_view::npos : pos + at;
+}
+
+inline std::size_t find_any_of_in(std::string_view haystack,
+                                  const ByteSet& set,
+                                  std::size_t pos) noexcept {
+    if (pos >= haystack.size())
+        return std::string_view::npos;
+    const std::size_t rest = haystack.size() - pos;
+    const std::size_t at = find_any_of(haystack.data() + pos, rest, set);
+    return at == rest ? std::string_view::npos : pos + at;
+}
+
+} // namespace detail
+} // namespace smallstring
@@ -0,0 +1,176 @@
+/**
+ * @file segmented.hpp
+ * @brief Scatter/gather buffer that borrows large payloads instead of
+ *        copying them.
+ *
+ * Small pushes are coalesced into an owned `Buffer` exactly as usual; a
+ * string at or above the borrow threshold is recorded as a reference to the
+ * caller's bytes.  The message is then handed to the kernel as an `iovec`
+ * array (`writev`, `sendmsg`, io_uring) without the payload ever being
+ * copied.  POSIX only (`struct iovec`).
+ */
+
+#pragma once
+
+#if __has_include(<sys/uio.h>)
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <sys/uio.h>
+
+#include "smallstring.hpp"
+
+namespace smallstring {
+
+/**
+ * @class SegmentedBuffer
+ * @brief A `Buffer` whose large `push`es are borrowed, not copied.
+ *
+ * @code
+ *   smallstring::SegmentedBuffer<> msg;
+ *   msg.push("{\"seq\":");
+ *   msg.push(seq);
+ *   msg.push(",\"snapshot\":");
+ *   msg.push(cached_snapshot); // std::string_view, borrowed
+ *   msg.push("}\n");
+ *   const auto& iov = msg.iovecs();
+ *   ::writev(fd, iov.data(), static_cast<int>(iov.size()));
+ * @endcode
+ *
+ * `push(std::string_view)`, `push(const char*, size_t)` and
+ * `push(const std::string&)` borrow when the string is at least
+ * `borrow_threshold()` bytes; the referenced bytes must then stay alive and
+ * unchanged until the buffer is cleared.  String literals, rvalue
+ * `std::string`s and every formatted push are always copied.
+ */
+template <class BufferType = Buffer<>>
+class SegmentedBuffer : public PushInterface<SegmentedBuffer<BufferType>> {
+  private:
+    /// A borrowed run, plus the owned bytes written just before it.
+    struct Segment {
+        std::size_t owned_end; ///< End of the owned run preceding this one
+        const char* data;      ///< Borrowed bytes
+        std::size_t length;
+    };
+
+    BufferType m_bytes;              ///< Coalesced owned bytes
+    std::vector<Segment> m_borrowed; ///< Borrowed runs, in push order
+    std::size_t m_borrowed_length = 0;
+    std::size_t m_threshold;
+    std::vector<iovec> m_iov; ///< Scratch for `iovecs()`
+    BufferType m_flat;        ///< Scratch for `view()`
+
+    using Base = PushInterface<SegmentedBuffer<BufferType>>;
+
+  public:
+    /// @brief @p threshold is the smallest string that gets borrowed.
+    explicit SegmentedBuffer(std::size_t threshold = 1024,
+                             std::size_t capacity = 256)
+        : m_bytes(capacity), m_threshold(threshold), m_flat(0) {}
+
+    /* --------------------------------------------------------------------- */
+    /*                                Push API                               */
+    /* --------------------------------------------------------------------- */
+
+    using Base::push;
+
+    /// @brief Append @p sz bytes at @p ptr, borrowing them if large enough.
+    void push(const char* ptr, std::size_t sz) {
+        if (sz < m_threshold)
+            Base::push(ptr, sz);
+        else
+            push_borrowed(std::string_view(ptr, sz));
+    }
+
+    /// @brief Append @p view, borrowing it if large enough.
+    void push(std::string_view view) { push(view.data(), view.length()); }
+
+    /// @brief Append @p str, borrowing it if large enough.
+    void push(const std::string& str) { push(str.data(), str.length()); }
+
+    /// @brief Temporaries are always copied.
+    void push(std::string&& str) { Base::push(str.data(), str.length()); }
+
+    /// @brief Reference @p view regardless of its size.
+    void push_borrowed(std::string_view view) {
+        if (view.empty())
+            return;
+        m_borrowed.push_back({m_bytes.length(), view.data(), view.length()});
+        m_borrowed_length += view.length();
+    }
+
+    /// @name Write-side primitives used by `PushInterface`.
+    /// @{
+    void ensure_fit(std::size_t n) { m_bytes.ensure_fit(n); }
+    char* tail() { return m_bytes.tail(); }
+    void advance(std::size_t n) { m_bytes.advance(n); }
+    /// @}
+
+    /* --------------------------------------------------------------------- */
+    /*                                Read API                               */
+    /* --------------------------------------------------------------------- */
+
+    /**
+     * @brief The message as an `iovec` array, in order.
+     *
+     * Valid until the next mutating call.  Adjacent owned bytes always form
+     * a single entry.
+     */
+    const std::vector<iovec>& iovecs() {
+        m_iov.clear();
+        m_iov.reserve(2 * m_borrowed.size() + 1);
+        char* owned = m_bytes.head();
+        std::size_t start = 0;
+        for (const Segment& segment : m_borrowed) {
+            if (segment.owned_end > start)
+                m_iov.push_back({owned + start, segment.owned_end - start});
+            m_iov.push_back({const_cast<char*>(segment.data), segment.length});
+            start = segment.owned_end;
+        }
+        if (m_bytes.length() > start)
+            m_iov.push_back({owned + start, m_bytes.length() - start});
+        return m_iov;
+    }
+
+    /**
+     * @brief The whole message as one contiguous view.
+     *
+     * Free when nothing was borrowed; otherwise the segments are copied
+     * into an internal buffer, reused across calls.
+     */
+    std::string_view view() {
+        if (m_borrowed.empty())
+            return m_bytes.view();
+        m_flat.clear();
+        m_flat.ensure_fit(length());
+        for (const iovec& part : iovecs())
+            m_flat.push(static_cast<const char*>(part.iov_base), part.iov_len);
+        return m_flat.view();
+    }
+
+    /// @brief Total bytes, owned and borrowed.
+    std::size_t length() const { return m_bytes.length() + m_borrowed_length; }
+
+    /// @brief Bytes copied into the owned buffer.
+    std::size_t owned_length() const { return m_bytes.length(); }
+
+    /// @brief Bytes referenced rather than copied.
+    std::size_t borrowed_length() const { return m_borrowed_length; }
+
+    std::size_t borrow_threshold() const { return m_threshold; }
+
+    /// @brief Forget every segment; borrowed bytes may be released after.
+    void clear() {
+        m_bytes.clear();
+        m_borrowed.clear();
+        m_borrowed_length = 0;
+    }
+};
+
+} // namespace smallstring
+
+#endif
@@ -0,0 +1,88 @@
+/**
+ * @file simd.hpp
+ * @brief Compile-time SIMD selection shared by the vectorised scanners.
+ *
+ * The widest instruction set enabled for the translation unit is used
+ * (`-mavx2`, `-mssse3`, the x86-64 SSE2 baseline, or AArch64 NEON).  Defining
+ * `SMALLSTRING_NO_SIMD` forces the portable scalar code everywhere.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#if !defined(SMALLSTRING_NO_SIMD)
+#if defined(__AVX2__)
+#define SMALLSTRING_HAS_AVX2 1
+#endif
+#if defined(__SSSE3__)
+#define SMALLSTRING_HAS_SSSE3 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SMALLSTRING_HAS_SSE2 1
+#endif
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#define SMALLSTRING_HAS_NEON 1
+#endif
+#endif
+
+#if defined(SMALLSTRING_HAS_AVX2)
+#include <immintrin.h>
+#elif defined(SMALLSTRING_HAS_SSSE3)
+#include <tmmintrin.h>
+#elif defined(SMALLSTRING_HAS_SSE2)
+#include <emmintrin.h>
+#endif
+#if defined(SMALLSTRING_HAS_NEON)
+#include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h> // _BitScanForward
+#endif
+
+namespace smallstring {
+namespace detail {
+
+/// @brief Index of the lowest set bit of a non-zero @p mask.
+inline unsigned count_trailing_zeros(std::uint32_t mask) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#elif defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    unsigned index = 0;
+    while ((mask & 1U) == 0) {
+        mask >>= 1;
+        ++index;
+    }
+    return index;
+#endif
+}
+
+/// @brief Index of the lowest set bit of a non-zero 64-bit @p mask.
+inline unsigned count_trailing_zeros(std::uint64_t mask) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctzll(mask));
+#else
+    const auto low = static_cast<std::uint32_t>(mask);
+    return low ? count_trailing_zeros(low)
+               : 32U + count_trailing_zeros(static_cast<std::uint32_t>(
+                           mask >> 32));
+#endif
+}
+
+#if defined(SMALLSTRING_HAS_NEON)
+/// @brief 4 bits per byte lane: a 64-bit movemask equivalent for NEON.
+inline std::uint64_t neon_nibble_mask(uint8x16_t lanes) noexcept {
+    const uint8x8_t narrowed =
+        vshrn_n_u16(vreinterpretq_u16_u8(lanes), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+}
+#endif
+
+} // namespace detail
+} // namespace smallstring
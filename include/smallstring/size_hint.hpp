@@ -0,0 +1,142 @@
+/**
+ * @file size_hint.hpp
+ * @brief Initial capacities learned from the sizes of earlier messages.
+ *
+ * A call site keeps one `SizeHint`; every completed buffer reports its
+ * final length to it and new buffers start at the tracked high quantile
+ * (p99 by default) instead of a fixed guess.  Large message types stop
+ * reallocating on the way up and tiny ones stop over-allocating.
+ *
+ * @code
+ *   static smallstring::SizeHint hint;
+ *   auto buf = hint.make_buffer(); // a HintedBuffer<>
+ *   buf.push(...);                 // length reported on clear/destruction
+ * @endcode
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "smallstring.hpp"
+
+namespace smallstring {
+
+class SizeHint;
+
+/// @brief Stats policy reporting each completed message to a `SizeHint`.
+class HintStats : public NoStats {
+  private:
+    SizeHint* m_hint = nullptr;
+
+  public:
+    HintStats() = default;
+    HintStats(SizeHint& hint) noexcept : m_hint(&hint) {}
+
+    SizeHint* hint() const noexcept { return m_hint; }
+
+    inline void on_finish(std::size_t length) noexcept;
+};
+
+/// @brief `Buffer` that reports its message sizes to a `SizeHint`.
+template <class Alloc = std::allocator<char>, class Growth = DoublingGrowth>
+using HintedBuffer = Buffer<Alloc, Growth, VectorStorage<Alloc>, HintStats>;
+
+/**
+ * @class SizeHint
+ * @brief Thread-safe tracker of a quantile of message sizes.
+ *
+ * Sizes are counted in power-of-two buckets; every `update_interval`
+ * reports the quantile is recomputed and the counts are halved once they
+ * exceed `window`, so the hint follows shifts in the traffic.  The
+ * capacity is the power of two that holds the quantile's bucket, clamped
+ * to `[min_capacity, max_capacity]`.
+ */
+class SizeHint {
+  public:
+    static constexpr std::uint64_t update_interval = 64;
+    static constexpr std::uint64_t window = 4096;
+
+    explicit SizeHint(std::size_t initial_capacity = 256,
+                      double quantile = 0.99, std::size_t min_capacity = 16,
+                      std::size_t max_capacity = std::size_t(1) << 20)
+        : m_capacity(initial_capacity), m_quantile(quantile),
+          m_min(min_capacity), m_max(max_capacity) {}
+
+    SizeHint(const SizeHint&) = delete;
+    SizeHint& operator=(const SizeHint&) = delete;
+
+    /// @brief The capacity new buffers should start with.
+    std::size_t capacity() const noexcept {
+        return m_capacity.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Report a completed message of @p length bytes.
+    void record(std::size_t length) noexcept {
+        if (length == 0)
+            return;
+        m_counts[StatsCounters::bucket(length)].fetch_add(
+            1, std::memory_order_relaxed);
+        if (m_reports.fetch_add(1, std::memory_order_relaxed) %
+                update_interval ==
+            update_interval - 1)
+            update();
+    }
+
+    /// @brief A `HintedBuffer` (or @p BufferType) starting at `capacity()`
+    ///        and reporting back here.
+    template <class BufferType = HintedBuffer<>>
+    BufferType make_buffer() {
+        return BufferType(capacity(), typename BufferType::allocator_type(),
+                          HintStats(*this));
+    }
+
+  private:
+    std::atomic<std::uint64_t> m_counts[StatsCounters::buckets] = {};
+    std::atomic<std::uint64_t> m_reports{0};
+    std::atomic<std::size_t> m_capacity;
+    double m_quantile;
+    std::size_t m_min;
+    std::size_t m_max;
+
+    void update() noexcept {
+        std::uint64_t counts[StatsCounters::buckets];
+        std::uint64_t total = 0;
+        for (std::size_t k = 0; k < StatsCounters::buckets; k++) {
+            counts[k] = m_counts[k].load(std::memory_order_relaxed);
+            total += counts[k];
+        }
+        if (total == 0)
+            return;
+        const auto rank = static_cast<std::uint64_t>(
+            m_quantile * static_cast<double>(total - 1));
+        std::size_t bucket = 1;
+        for (std::uint64_t seen = 0; bucket < StatsCounters::buckets;
+             bucket++) {
+            seen += counts[bucket];
+            if (seen > rank)
+                break;
+        }
+        // Bucket k holds lengths below 2^k.
+        std::size_t capacity =
+            bucket >= 64 ? m_max : std::size_t(1) << bucket;
+        capacity = capacity < m_min ? m_min : capacity;
+        capacity = capacity > m_max ? m_max : capacity;
+        m_capacity.store(capacity, std::memory_order_relaxed);
+
+        if (total > window) {
+            for (std::size_t k = 0; k < StatsCounters::buckets; k++)
+                m_counts[k].fetch_sub(counts[k] / 2,
+                                      std::memory_order_relaxed);
+        }
+    }
+};
+
+void HintStats::on_finish(std::size_t length) noexcept {
+    if (m_hint)
+        m_hint->record(length);
+}
+
+} // namespace smallstring
@@ -3,7 +3,7 @@
  * @brief Small, self-contained string-building buffer.
  *
  * `smallstring::Buffer` is a grow-as-needed, *write-only* buffer that lets you
- * incrementally append character data and integral values without paying the
+ * incrementally append character data and numeric values without paying the
  * overhead of `std::ostringstream` or repeated `std::string` reallocations.
  *
  * ### Design goals
@@ -18,22 +18,1097 @@
 #pragma once
 
 #include <algorithm> // std::copy
-#include <cmath>     // std::abs
+#include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <iterator> // std::data, std::size
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
 #include <string>
 #include <string_view>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "encoding.hpp"
+#include "escape.hpp"
+#include "floating.hpp"
+#include "integer.hpp"
+#include "search.hpp"
+
 namespace smallstring {
 
+/* ------------------------------------------------------------------------- */
+/*                             Growth policies                               */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * A growth policy is any type with a static
+ * `std::size_t grow(std::size_t capacity, std::size_t required)` returning the
+ * new capacity (which must be ≥ @p required) when a push overflows.
+ */
+
+/// @brief Double the capacity (or jump straight to @p required if larger).
+struct DoublingGrowth {
+    static std::size_t grow(std::size_t capacity,
+                            std::size_t required) noexcept {
+        return std::max(required, capacity * 2);
+    }
+};
+
+/// @brief Grow to exactly the requested size (the original behaviour).
+struct ExactGrowth {
+    static std::size_t grow(std::size_t /*capacity*/,
+                            std::size_t required) noexcept {
+        return required;
+    }
+};
+
+namespace detail {
+
+/**
+ * @brief Allocator adaptor that *default*-initialises elements.
+ *
+ * `std::vector<char>::resize` value-initialises (zero-fills) new bytes, which
+ * is wasted work when they are about to be overwritten by a push.  Routing
+ * the no-argument `construct` to placement default-init makes it a no-op for
+ * `char`.  Every other operation is forwarded to @p A.
+ */
+template <class T, class A = std::allocator<T>>
+class DefaultInitAllocator : public A {
+    using traits = std::allocator_traits<A>;
+
+  public:
+    template <class U> struct rebind {
+        using other =
+            DefaultInitAllocator<U, typename traits::template rebind_alloc<U>>;
+    };
+
+    using A::A;
+
+    DefaultInitAllocator() = default;
+    DefaultInitAllocator(const A& alloc) noexcept : A(alloc) {}
+
+    template <class U, class B>
+    DefaultInitAllocator(const DefaultInitAllocator<U, B>& other) noexcept
+        : A(static_cast<const B&>(other)) {}
+
+    DefaultInitAllocator select_on_container_copy_construction() const {
+        return DefaultInitAllocator(
+            traits::select_on_container_copy_construction(*this));
+    }
+
+    template <class U>
+    void construct(U* ptr) noexcept(
+        std::is_nothrow_default_constructible<U>::value) {
+        ::new (static_cast<void*>(ptr)) U;
+    }
+
+    template <class U, class... Args> void construct(U* ptr, Args&&... args) {
+        traits::construct(static_cast<A&>(*this), ptr,
+                          std::forward<Args>(args)...);
+    }
+};
+
+} // namespace detail
+
+/* ------------------------------------------------------------------------- */
+/*                            Storage policies                               */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * A storage policy owns the raw bytes behind a `Buffer`.  It must provide:
+ *
+ * * `static constexpr std::size_t default_capacity` – capacity used by the
+ *   default-constructed `Buffer`;
+ * * a `(std::size_t capacity, const Alloc&)` constructor;
+ * * `data()` / `size()` – base pointer and capacity in bytes;
+ * * `grow(capacity, used)` – enlarge to @p capacity, preserving the first
+ *   @p used bytes (bytes past @p used may be left uninitialised);
+ * * `release()` – return to the smallest possible footprint;
+ * * for a copyable `Buffer`, a `(const Storage& other, first, last)`
+ *   constructor and `assign(const Storage& other, first, last)` – copy as
+ *   copy construction / assignment would, but only bytes `[first, last)` of
+ *   @p other, to offset 0;
+ * * for a movable `Buffer`, a `(Storage&& other, first, last)` constructor
+ *   and `assign(Storage&& other, first, last)` – move as usual, but where
+ *   bytes have to be copied only `[first, last)` of @p other need to be,
+ *   and they stay at the same offsets.
+ */
+
+/// @brief Heap storage backed by a (non zero-filling) `std::vector`.
+template <class Alloc = std::allocator<char>> class VectorStorage {
+  private:
+    using vector_type =
+        std::vector<char, detail::DefaultInitAllocator<char, Alloc>>;
+    using traits =
+        std::allocator_traits<typename vector_type::allocator_type>;
+
+    static constexpr bool nothrow_move_assign =
+        traits::propagate_on_container_move_assignment::value ||
+        traits::is_always_equal::value;
+
+    vector_type m_data;
+
+  public:
+    static constexpr std::size_t default_capacity = 256;
+
+    explicit VectorStorage(std::size_t capacity, const Alloc& alloc = Alloc())
+        : m_data(capacity, alloc) {}
+
+    /// @brief Same capacity as @p other, holding its bytes `[first, last)`.
+    VectorStorage(const VectorStorage& other, std::size_t first,
+                  std::size_t last)
+        : m_data(other.m_data.size(),
+                 traits::select_on_container_copy_construction(
+                     other.m_data.get_allocator())) {
+        std::copy(other.data() + first, other.data() + last, data());
+    }
+
+    /// @brief Copy @p other's bytes `[first, last)`, reallocating only if
+    ///        they don't fit; allocators propagate as for the vector.
+    void assign(const VectorStorage& other, std::size_t first,
+                std::size_t last) {
+        if constexpr (traits::propagate_on_container_copy_assignment::value) {
+            if (m_data.get_allocator() != other.m_data.get_allocator()) {
+                const vector_type empty(other.m_data.get_allocator());
+                m_data = empty; // adopts the allocator, frees our block
+            }
+        }
+        if (m_data.size() < last - first) {
+            m_data.clear(); // nothing to preserve when reallocating
+            m_data.resize(other.m_data.size());
+        }
+        std::copy(other.data() + first, other.data() + last, data());
+    }
+
+    /// @brief Take @p other's vector; nothing is copied.
+    VectorStorage(VectorStorage&& other, std::size_t, std::size_t) noexcept
+        : m_data(std::move(other.m_data)) {}
+
+    /// @brief Take @p other's vector, or – with unequal, non-propagating
+    ///        allocators – copy just its bytes `[first, last)`, in place.
+    void assign(VectorStorage&& other, std::size_t first,
+                std::size_t last) noexcept(nothrow_move_assign) {
+        if (traits::propagate_on_container_move_assignment::value ||
+            m_data.get_allocator() == other.m_data.get_allocator()) {
+            m_data = std::move(other.m_data);
+            return;
+        }
+        if (m_data.size() < last) {
+            m_data.clear();
+            m_data.resize(other.m_data.size());
+        }
+        std::copy(other.data() + first, other.data() + last, data() + first);
+    }
+
+    char* data() noexcept { return m_data.data(); }
+    const char* data() const noexcept { return m_data.data(); }
+    std::size_t size() const noexcept { return m_data.size(); }
+
+    void grow(std::size_t capacity, std::size_t /*used*/) {
+        m_data.resize(capacity);
+    }
+
+    void release() {
+        m_data.clear();
+        m_data.shrink_to_fit();
+    }
+};
+
+/**
+ * @brief Small-buffer storage: the first @p N bytes live inside the object.
+ *
+ * Nothing is allocated until the contents outgrow @p N, at which point the
+ * bytes spill to a block obtained from @p Alloc.  `release()` frees that
+ * block and returns to the inline array.
+ */
+template <std::size_t N, class Alloc = std::allocator<char>>
+class InlineStorage {
+    static_assert(N > 0, "InlineStorage needs a non-zero inline capacity");
+
+  private:
+    using traits = std::allocator_traits<Alloc>;
+
+    static constexpr bool nothrow_move_assign =
+        traits::propagate_on_container_move_assignment::value ||
+        traits::is_always_equal::value;
+
+    Alloc m_alloc;
+    char* m_data;       ///< Either `m_inline` or a heap block
+    std::size_t m_size; ///< Capacity of `m_data`
+    char m_inline[N];
+
+    bool is_inline() const noexcept { return m_data == m_inline; }
+
+    void deallocate() noexcept {
+        if (!is_inline())
+            traits::deallocate(m_alloc, m_data, m_size);
+        m_data = m_inline;
+        m_size = N;
+    }
+
+    /// @brief Take @p other's bytes; @p other must share our allocator.
+    ///        Inline contents are copied, `[first, last)` only.
+    void steal(InlineStorage& other, std::size_t first,
+               std::size_t last) noexcept {
+        if (other.is_inline()) {
+            std::copy(other.m_inline + first, other.m_inline + last,
+                      m_inline + first);
+            return;
+        }
+        m_data = other.m_data;
+        m_size = other.m_size;
+        other.m_data = other.m_inline;
+        other.m_size = N;
+    }
+
+    /// @brief Copy @p size bytes in at offset @p at; if they don't fit,
+    ///        reallocate to @p capacity (at least `at + size`) first.
+    void copy_in(const char* data, std::size_t size, std::size_t capacity,
+                 std::size_t at = 0) {
+        if (at + size > m_size) {
+            char* fresh = traits::allocate(m_alloc, capacity);
+            deallocate();
+            m_data = fresh;
+            m_size = capacity;
+        }
+        std::copy(data, data + size, m_data + at);
+    }
+
+  public:
+    static constexpr std::size_t default_capacity = N;
+
+    explicit InlineStorage(std::size_t capacity, const Alloc& alloc = Alloc())
+        : m_alloc(alloc), m_data(m_inline), m_size(N) {
+        if (capacity > N) {
+            m_data = traits::allocate(m_alloc, capacity);
+            m_size = capacity;
+        }
+    }
+
+    InlineStorage(const InlineStorage& other)
+        : InlineStorage(other, 0, other.m_size) {}
+
+    /// @brief Hold @p other's bytes `[first, last)`: inline if they fit,
+    ///        otherwise in a block of @p other's capacity.
+    InlineStorage(const InlineStorage& other, std::size_t first,
+                  std::size_t last)
+        : m_alloc(traits::select_on_container_copy_construction(
+              other.m_alloc)),
+          m_data(m_inline), m_size(N) {
+        copy_in(other.m_data + first, last - first, other.m_size);
+    }
+
+    InlineStorage(InlineStorage&& other) noexcept
+        : InlineStorage(std::move(other), 0, N) {}
+
+    /// @brief Take @p other's heap block, or copy its inline bytes
+    ///        `[first, last)`.
+    InlineStorage(InlineStorage&& other, std::size_t first,
+                  std::size_t last) noexcept
+        : m_alloc(std::move(other.m_alloc)), m_data(m_inline), m_size(N) {
+        steal(other, first, last);
+    }
+
+    InlineStorage& operator=(const InlineStorage& other) {
+        if (this != &other)
+            assign(other, 0, other.m_size);
+        return *this;
+    }
+
+    /// @brief Copy @p other's bytes `[first, last)`, reallocating only if
+    ///        they don't fit.
+    ///
+    /// Honours `propagate_on_container_copy_assignment`: unless it is set,
+    /// the bytes are copied into memory from this object's own allocator.
+    void assign(const InlineStorage& other, std::size_t first,
+                std::size_t last) {
+        if constexpr (traits::propagate_on_container_copy_assignment::value) {
+            if (m_alloc != other.m_alloc)
+                deallocate();
+            m_alloc = other.m_alloc;
+        }
+        copy_in(other.m_data + first, last - first, other.m_size);
+    }
+
+    InlineStorage& operator=(InlineStorage&& other) noexcept(
+        nothrow_move_assign) {
+        if (this != &other)
+            assign(std::move(other), 0, other.m_size);
+        return *this;
+    }
+
+    /// @brief Take @p other's bytes, of which only `[first, last)` is
+    ///        copied where copying is needed.
+    ///
+    /// Honours `propagate_on_container_move_assignment`: with unequal,
+    /// non-propagating allocators the bytes are copied rather than stolen.
+    void assign(InlineStorage&& other, std::size_t first,
+                std::size_t last) noexcept(nothrow_move_assign) {
+        if (traits::propagate_on_container_move_assignment::value ||
+            m_alloc == other.m_alloc) {
+            deallocate();
+            if constexpr (traits::propagate_on_container_move_assignment::
+                              value)
+                m_alloc = std::move(other.m_alloc);
+            steal(other, first, last);
+        } else {
+            copy_in(other.m_data + first, last - first, other.m_size, first);
+        }
+    }
+
+    ~InlineStorage() { deallocate(); }
+
+    char* data() noexcept { return m_data; }
+    const char* data() const noexcept { return m_data; }
+    std::size_t size() const noexcept { return m_size; }
+
+    /// @brief True while the contents still fit in the inline array.
+    bool is_small() const noexcept { return is_inline(); }
+
+    void grow(std::size_t capacity, std::size_t used) {
+        char* fresh = traits::allocate(m_alloc, capacity);
+        std::copy(m_data, m_data + used, fresh);
+        deallocate();
+        m_data = fresh;
+        m_size = capacity;
+    }
+
+    void release() noexcept { deallocate(); }
+};
+
+namespace detail {
+
+/// @brief Whether @p A has `char* reallocate(char*, old, new, used)`.
+template <class A, class = void> struct has_reallocate : std::false_type {};
+
+template <class A>
+struct has_reallocate<A, std::void_t<decltype(std::declval<A&>().reallocate(
+                             std::declval<char*>(), std::size_t(),
+                             std::size_t(), std::size_t()))>>
+    : std::true_type {};
+
+} // namespace detail
+
+/**
+ * @brief Heap storage that lets the allocator resize a block in place.
+ *
+ * If @p Alloc has a member
+ * `char* reallocate(char* ptr, std::size_t old_size, std::size_t new_size,
+ * std::size_t used)` – which returns the resized block holding the first
+ * @p used bytes, or throws leaving @p ptr intact – `grow` goes through it,
+ * so e.g. `mremap` can move pages instead of copying bytes.  Otherwise it
+ * allocates, copies the used bytes and deallocates, like `VectorStorage`.
+ */
+template <class Alloc = std::allocator<char>> class ReallocStorage {
+  private:
+    using traits = std::allocator_traits<Alloc>;
+
+    static constexpr bool nothrow_move_assign =
+        traits::propagate_on_container_move_assignment::value ||
+        traits::is_always_equal::value;
+
+    Alloc m_alloc;
+    char* m_data = nullptr;
+    std::size_t m_size = 0;
+
+    void deallocate() noexcept {
+        if (m_data)
+            traits::deallocate(m_alloc, m_data, m_size);
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    /// @brief Copy @p size bytes in at offset @p at; if they don't fit,
+    ///        reallocate to @p capacity (at least `at + size`) first.
+    void copy_in(const char* data, std::size_t size, std::size_t capacity,
+                 std::size_t at = 0) {
+        if (at + size > m_size || !m_data) {
+            char* fresh =
+                capacity ? traits::allocate(m_alloc, capacity) : nullptr;
+            deallocate();
+            m_data = fresh;
+            m_size = capacity;
+        }
+        if (size)
+            std::memcpy(m_data + at, data, size);
+    }
+
+  public:
+    static constexpr std::size_t default_capacity = 256;
+
+    explicit ReallocStorage(std::size_t capacity, const Alloc& alloc = Alloc())
+        : m_alloc(alloc) {
+        if (capacity) {
+            m_data = traits::allocate(m_alloc, capacity);
+            m_size = capacity;
+        }
+    }
+
+    ReallocStorage(const ReallocStorage& other)
+        : ReallocStorage(other, 0, other.m_size) {}
+
+    /// @brief Same capacity as @p other, holding its bytes `[first, last)`.
+    ReallocStorage(const ReallocStorage& other, std::size_t first,
+                   std::size_t last)
+        : m_alloc(
+              traits::select_on_container_copy_construction(other.m_alloc)) {
+        copy_in(other.m_data + first, last - first, other.m_size);
+    }
+
+    ReallocStorage(ReallocStorage&& other) noexcept
+        : m_alloc(std::move(other.m_alloc)),
+          m_data(std::exchange(other.m_data, nullptr)),
+          m_size(std::exchange(other.m_size, 0)) {}
+
+    /// @brief Take @p other's block; nothing is copied.
+    ReallocStorage(ReallocStorage&& other, std::size_t, std::size_t) noexcept
+        : ReallocStorage(std::move(other)) {}
+
+    ReallocStorage& operator=(const ReallocStorage& other) {
+        if (this != &other)
+            assign(other, 0, other.m_size);
+        return *this;
+    }
+
+    /// @brief Copy @p other's bytes `[first, last)`, reallocating only if
+    ///        they don't fit; allocators propagate as for `InlineStorage`.
+    void assign(const ReallocStorage& other, std::size_t first,
+                std::size_t last) {
+        if constexpr (traits::propagate_on_container_copy_assignment::value) {
+            if (m_alloc != other.m_alloc)
+                deallocate();
+            m_alloc = other.m_alloc;
+        }
+        copy_in(other.m_data + first, last - first, other.m_size);
+    }
+
+    ReallocStorage& operator=(ReallocStorage&& other) noexcept(
+        nothrow_move_assign) {
+        if (this != &other)
+            assign(std::move(other), 0, other.m_size);
+        return *this;
+    }
+
+    /// @brief Take @p other's block, or – with unequal, non-propagating
+    ///        allocators – copy just its bytes `[first, last)`, in place.
+    void assign(ReallocStorage&& other, std::size_t first,
+                std::size_t last) noexcept(nothrow_move_assign) {
+        if (traits::propagate_on_container_move_assignment::value ||
+            m_alloc == other.m_alloc) {
+            deallocate();
+            if constexpr (traits::propagate_on_container_move_assignment::
+                              value)
+                m_alloc = std::move(other.m_alloc);
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+        } else {
+            copy_in(other.m_data + first, last - first, other.m_size, first);
+        }
+    }
+
+    ~ReallocStorage() { deallocate(); }
+
+    char* data() noexcept { return m_data; }
+    const char* data() const noexcept { return m_data; }
+    std::size_t size() const noexcept { return m_size; }
+
+    void grow(std::size_t capacity, std::size_t used) {
+        if constexpr (detail::has_reallocate<Alloc>::value) {
+            if (m_data) {
+                m_data = m_alloc.reallocate(m_data, m_size, capacity, used);
+                m_size = capacity;
+                return;
+            }
+        }
+        char* fresh = traits::allocate(m_alloc, capacity);
+        if (used)
+            std::memcpy(fresh, m_data, used);
+        deallocate();
+        m_data = fresh;
+        m_size = capacity;
+    }
+
+    void release() noexcept { deallocate(); }
+};
+
+/* ------------------------------------------------------------------------- */
+/*                              Stats policies                               */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * A stats policy observes a `Buffer`'s hot path.  It is an (empty, for
+ * `NoStats`) base of the buffer and must provide:
+ *
+ * * `on_grow(old_capacity, new_capacity, copied)` – storage was resized;
+ * * `on_compact(copied)` – popped bytes were reclaimed by sliding;
+ * * `on_length(length)` – bytes were appended;
+ * * `on_finish(length)` – a message of @p length bytes was completed
+ *   (`clear()`, `drop_memory()` or destruction with content).
+ */
+
+/// @brief No instrumentation; every hook compiles away.
+struct NoStats {
+    void on_grow(std::size_t, std::size_t, std::size_t) noexcept {}
+    void on_compact(std::size_t) noexcept {}
+    void on_length(std::size_t) noexcept {}
+    void on_finish(std::size_t) noexcept {}
+};
+
+/// @brief Plain counters shared by `BufferStats` and the stats registry.
+struct StatsCounters {
+    /// Bucket `k` counts messages of `[2^(k-1), 2^k)` bytes; bucket 0 is
+    /// unused (empty messages are not recorded).
+    static constexpr std::size_t buckets = 65;
+
+    std::uint64_t resizes = 0;      ///< `ensure_fit` calls that reallocated
+    std::uint64_t bytes_copied = 0; ///< By reallocation and compaction
+    std::uint64_t peak_length = 0;  ///< Largest `length()` seen
+    std::uint64_t messages = 0;     ///< Completed messages
+    std::uint64_t size_histogram[buckets] = {};
+
+    static std::size_t bucket(std::size_t length) noexcept {
+        return detail::log2_floor(length) + 1;
+    }
+
+    /**
+     * @brief Upper bound on the @p quantile (0..1) of message sizes.
+     *
+     * Returns the top of the histogram bucket the quantile falls in, i.e.
+     * a power of two minus one; 0 if no message was recorded.
+     */
+    std::size_t percentile(double quantile) const noexcept {
+        if (messages == 0)
+            return 0;
+        const auto rank = static_cast<std::uint64_t>(
+            quantile * static_cast<double>(messages - 1));
+        std::uint64_t seen = 0;
+        for (std::size_t k = 1; k < buckets; k++) {
+            seen += size_histogram[k];
+            if (seen > rank)
+                return k >= 64 ? ~std::size_t(0)
+                               : (std::size_t(1) << k) - 1;
+        }
+        return ~std::size_t(0);
+    }
+};
+
+/// @brief Per-buffer counters, read back with `Buffer::stats()`.
+struct BufferStats : StatsCounters {
+    void on_grow(std::size_t, std::size_t, std::size_t copied) noexcept {
+        resizes++;
+        bytes_copied += copied;
+    }
+    void on_compact(std::size_t copied) noexcept { bytes_copied += copied; }
+    void on_length(std::size_t length) noexcept {
+        if (length > peak_length)
+            peak_length = length;
+    }
+    void on_finish(std::size_t length) noexcept {
+        messages++;
+        size_histogram[bucket(length)]++;
+    }
+};
+
+/**
+ * @class ReservedWriter
+ * @brief Unchecked appends into space reserved up front.
+ *
+ * Obtained from `reserve_writer(max_bytes)`, which calls `ensure_fit` once.
+ * The `push_unchecked` overloads then write through a local pointer with no
+ * capacity checks, and the bytes written are committed to the buffer when
+ * the writer is destroyed.  The caller guarantees that at most `max_bytes`
+ * are written (checked by `assert` in debug builds), and must not touch the
+ * buffer while the writer is alive.
+ *
+ * @code
+ *   {
+ *       auto w = buf.reserve_writer(64);
+ *       w.push_unchecked("id=");
+ *       w.push_unchecked(id);
+ *       w.push_char_unchecked(' ');
+ *   } // committed here
+ * @endcode
+ */
+template <class Owner> class ReservedWriter {
+  private:
+    Owner& m_owner;
+    char* m_start;
+    char* m_out;
+#ifndef NDEBUG
+    char* m_limit;
+#endif
+
+    char* claim(std::size_t n) {
+        assert(static_cast<std::size_t>(m_limit - m_out) >= n &&
+               "ReservedWriter: wrote past the reservation");
+        (void)n;
+        return m_out;
+    }
+
+  public:
+    ReservedWriter(Owner& owner, std::size_t max_bytes)
+        : m_owner(owner), m_start(owner.tail()), m_out(m_start) {
+#ifndef NDEBUG
+        m_limit = m_start + max_bytes;
+#endif
+        (void)max_bytes;
+    }
+
+    ReservedWriter(const ReservedWriter&) = delete;
+    ReservedWriter& operator=(const ReservedWriter&) = delete;
+
+    ~ReservedWriter() { m_owner.advance(written()); }
+
+    /// @brief Bytes written so far.
+    std::size_t written() const { return m_out - m_start; }
+
+    void push_unchecked(const char* ptr, std::size_t sz) {
+        m_out = std::copy(ptr, ptr + sz, claim(sz));
+    }
+
+    template <std::size_t N> void push_unchecked(const char (&ptr)[N]) {
+        push_unchecked(ptr, N - 1);
+    }
+
+    void push_unchecked(std::string_view view) {
+        push_unchecked(view.data(), view.length());
+    }
+
+    /// @brief Base-10, like `push(T)` (so `char` prints as a number too).
+    template <typename T,
+              typename = std::enable_if_t<std::is_integral<T>::value>>
+    void push_unchecked(T number) {
+        const std::size_t length = detail::integer_length(number);
+        detail::write_integer(claim(length), number, length);
+        m_out += length;
+    }
+
+    /// @brief Shortest round-trip form, like `push(T)`.
+    template <typename T,
+              std::enable_if_t<std::is_floating_point<T>::value, int> = 0>
+    void push_unchecked(T number) {
+        using F = std::conditional_t<std::is_same<T, float>::value, float,
+                                     double>;
+        m_out = detail::format_shortest(claim(detail::max_shortest_chars<F>),
+                                        static_cast<F>(number));
+    }
+
+    /// @brief Fixed precision, like `push_fixed`; reserve
+    ///        `detail::max_fixed_chars(number, precision)` for it.
+    template <typename T,
+              std::enable_if_t<std::is_floating_point<T>::value, int> = 0>
+    void push_fixed_unchecked(T number, std::size_t precision) {
+        using F = std::conditional_t<std::is_same<T, float>::value, float,
+                                     double>;
+        const auto value = static_cast<F>(number);
+        m_out = detail::format_fixed(
+            claim(detail::max_fixed_chars(value, precision)), value,
+            precision);
+    }
+
+    /// @brief JSON-escaped, like `push_escaped`; reserve
+    ///        `str.size() * detail::max_json_escape_chars` for it.
+    void push_escaped_unchecked(std::string_view str) {
+        m_out = detail::write_json_escaped(
+            claim(str.size() * detail::max_json_escape_chars), str.data(),
+            str.size());
+    }
+
+    /// @brief Append the single byte @p c.
+    void push_char_unchecked(char c) {
+        *claim(1) = c;
+        m_out++;
+    }
+};
+
+/* ------------------------------------------------------------------------- */
+/*                          Length-prefixed frames                           */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * A frame encoding is any type with
+ * * `template <class T> static constexpr std::size_t max_size()` – header
+ *   bytes to reserve for a length of type `T`;
+ * * `template <class T> static std::size_t encode(char* out, T length)` –
+ *   write the header, at most `max_size<T>()` bytes, and return its size.
+ *
+ * Headers shorter than the reservation are closed up by moving the body.
+ */
+
+/// @brief Fixed `sizeof(T)` bytes, most significant first (network order).
+struct FrameBigEndian {
+    template <class T> static constexpr std::size_t max_size() {
+        return sizeof(T);
+    }
+
+    template <class T> static std::size_t encode(char* out, T length) {
+        for (std::size_t i = sizeof(T); i-- > 0; length >>= 8)
+            out[i] = static_cast<char>(length & 0xFF);
+        return sizeof(T);
+    }
+};
+
+/// @brief Fixed `sizeof(T)` bytes, least significant first.
+struct FrameLittleEndian {
+    template <class T> static constexpr std::size_t max_size() {
+        return sizeof(T);
+    }
+
+    template <class T> static std::size_t encode(char* out, T length) {
+        for (std::size_t i = 0; i < sizeof(T); i++, length >>= 8)
+            out[i] = static_cast<char>(length & 0xFF);
+        return sizeof(T);
+    }
+};
+
+/// @brief LEB128 / protobuf varint: 7 bits per byte, shortest form.
+struct FrameVarint {
+    template <class T> static constexpr std::size_t max_size() {
+        return (std::numeric_limits<T>::digits + 6) / 7;
+    }
+
+    template <class T> static std::size_t encode(char* out, T length) {
+        std::size_t n = 0;
+        for (; length >= 0x80; length >>= 7)
+            out[n++] = static_cast<char>((length & 0x7F) | 0x80);
+        out[n++] = static_cast<char>(length);
+        return n;
+    }
+};
+
+/// @brief Decimal digits, shortest form (add any separator yourself).
+struct FrameAscii {
+    template <class T> static constexpr std::size_t max_size() {
+        return detail::max_integer_chars<T>;
+    }
+
+    template <class T> static std::size_t encode(char* out, T length) {
+        const std::size_t n = detail::integer_length(length);
+        detail::write_integer(out, length, n);
+        return n;
+    }
+};
+
+/**
+ * @class Frame
+ * @brief An open length-prefixed frame; see `Buffer::begin_frame`.
+ *
+ * The header position is kept as an offset from `head()`, so the frame
+ * survives the buffer growing.  Frames nest, but must be ended in reverse
+ * order of opening, and the buffer must not be `pop`ped or cleared while a
+ * frame is open.  A frame still open when destroyed is ended then, or –
+ * if its body no longer fits in `T` – dropped from the buffer, header and
+ * body, since a destructor cannot report the overflow.
+ */
+template <class Owner, class T, class Encoding> class Frame {
+    static_assert(std::is_integral<T>::value && std::is_unsigned<T>::value,
+                  "Frame: the length type must be an unsigned integer");
+
+  private:
+    static constexpr std::size_t reserved = Encoding::template max_size<T>();
+
+    Owner* m_owner;
+    std::size_t m_header; ///< Header offset from `head()`
+
+  public:
+    explicit Frame(Owner& owner) : m_owner(&owner) {
+        owner.ensure_fit(reserved);
+        m_header = owner.length();
+        owner.advance(reserved);
+    }
+
+    Frame(Frame&& other) noexcept
+        : m_owner(std::exchange(other.m_owner, nullptr)),
+          m_header(other.m_header) {}
+
+    Frame(const Frame&) = delete;
+    Frame& operator=(const Frame&) = delete;
+    Frame& operator=(Frame&&) = delete;
+
+    ~Frame() {
+        if (!m_owner)
+            return;
+        if (length() > std::numeric_limits<T>::max())
+            m_owner->truncate(m_header); // abandon the frame
+        else
+            end();
+    }
+
+    /// @brief Body bytes written so far (the header excluded).
+    std::size_t length() const {
+        return m_owner->length() - m_header - reserved;
+    }
+
+    /**
+     * @brief Write the header for the body pushed since `begin_frame`.
+     *
+     * @throws std::length_error if the body does not fit in `T`; the frame
+     *         stays open.
+     */
+    void end() {
+        const std::size_t body = length();
+        if (body > std::numeric_limits<T>::max())
+            throw std::length_error("Frame: body too long for length type");
+        char header[reserved];
+        const std::size_t size =
+            Encoding::template encode<T>(header, static_cast<T>(body));
+        char* out = m_owner->head() + m_header;
+        std::memcpy(out, header, size);
+        if (size != reserved) {
+            std::memmove(out + size, out + reserved, body);
+            m_owner->truncate(m_owner->length() - (reserved - size));
+        }
+        m_owner = nullptr;
+    }
+};
+
+/**
+ * @class PushInterface
+ * @brief The `push` API, shared by every buffer type in the library.
+ *
+ * CRTP base: @p Derived must provide
+ *
+ * * `void ensure_fit(std::size_t n)` – make `n` contiguous bytes writable at
+ *   `tail()`;
+ * * `char* tail()` – where the next byte goes;
+ * * `void advance(std::size_t n)` – mark `n` bytes written at `tail()` as
+ *   used.
+ *
+ * Every overload reserves once and then writes straight into `tail()`.
+ * The text and integer overloads are `constexpr` in C++20, for
+ * `StaticBuffer`.
+ */
+template <class Derived> class PushInterface {
+  private:
+    constexpr Derived& self() { return static_cast<Derived&>(*this); }
+
+  public:
+    /// @brief Append @p sz bytes starting at @p ptr.
+    SMALLSTRING_CONSTEXPR20 void push(const char* ptr, std::size_t sz) {
+        self().ensure_fit(sz);
+        std::copy(ptr, ptr + sz, self().tail());
+        self().advance(sz);
+    }
+
+    /// @brief Append a string literal (deduces size at compile time).
+    template <std::size_t N>
+    SMALLSTRING_CONSTEXPR20 void push(const char (&ptr)[N]) {
+        push(ptr, N - 1);
+    }
+
+    /// @brief Append the contents of a `std::string_view`.
+    SMALLSTRING_CONSTEXPR20 void push(std::string_view view) {
+        push(view.data(), view.length());
+    }
+
+    /// @brief Append the contents of a `std::string`.
+    SMALLSTRING_CONSTEXPR20 void push(const std::string& str) {
+        push(str.data(), str.length());
+    }
+
+    /**
+     * @brief Append @p str escaped for use inside a JSON string literal.
+     *
+     * `"`, `\` and control characters are escaped (`\n`, `\u001f`, …);
+     * everything else, including UTF-8 sequences, is copied verbatim.  The
+     * input is scanned 16 / 32 bytes at a time and clean runs are copied in
+     * blocks.  No surrounding quotes are written.
+     */
+    void push_escaped(std::string_view str) {
+        const char* ptr = str.data();
+        std::size_t remaining = str.size();
+        self().ensure_fit(remaining);
+        for (;;) {
+            const std::size_t run = detail::find_json_escape(ptr, remaining);
+            std::copy(ptr, ptr + run, self().tail());
+            self().advance(run);
+            if (run == remaining)
+                return;
+            ptr += run;
+            remaining -= run;
+            self().ensure_fit(remaining - 1 + detail::max_json_escape_chars);
+            char* out = self().tail();
+            self().advance(detail::write_json_escape(out, *ptr) - out);
+            ++ptr;
+            --remaining;
+        }
+    }
+
+    /**
+     * @brief Append an integral value in base-10 with no allocations.
+     *
+     * Handles signedness automatically (including the type's minimum).  The
+     * digit count comes from a log2 / power-of-ten table lookup and digits
+     * are written right-to-left two at a time, so the value is only divided
+     * once per pair of digits.
+     */
+    template <typename T,
+              typename = std::enable_if_t<std::is_integral<T>::value>>
+    SMALLSTRING_CONSTEXPR20 void push(T number) {
+        const std::size_t length = detail::integer_length(number);
+        self().ensure_fit(length);
+        detail::write_integer(self().tail(), number, length);
+        self().advance(length);
+    }
+
+    /**
+     * @brief Append a floating-point value in its shortest round-trip form.
+     *
+     * Output matches `std::to_chars(first, last, value)`: fixed or
+     * scientific notation, whichever is shorter, independent of the locale.
+     * `float` values print the shortest digits that round-trip as `float`
+     * ("0.1" rather than "0.10000000149011612").  Non-finite values are
+     * written as "inf", "-inf" or "nan".
+     */
+    template <typename T,
+              std::enable_if_t<std::is_floating_point<T>::value, int> = 0>
+    void push(T number) {
+        using F = std::conditional_t<std::is_same<T, float>::value, float,
+                                     double>;
+        self().ensure_fit(detail::max_shortest_chars<F>);
+        char* out = self().tail();
+        self().advance(detail::format_shortest(out, static_cast<F>(number)) -
+                       out);
+    }
+
+    /**
+     * @brief Append @p number with exactly @p precision fractional digits.
+     *
+     * Like `printf("%.*f")` but locale-independent, and working from the
+     * shortest round-trip decimal rather than the exact binary value:
+     * rounding is half away from zero, so `push_fixed(1.005, 2)` gives "1.01",
+     * and digits past the shortest representation are zero.
+     */
+    template <typename T,
+              std::enable_if_t<std::is_floating_point<T>::value, int> = 0>
+    void push_fixed(T number, std::size_t precision) {
+        using F = std::conditional_t<std::is_same<T, float>::value, float,
+                                     double>;
+        self().ensure_fit(
+            detail::max_fixed_chars(static_cast<F>(number), precision));
+        char* out = self().tail();
+        self().advance(
+            detail::format_fixed(out, static_cast<F>(number), precision) -
+            out);
+    }
+
+    /// @brief Append the bytes of @p bytes as lowercase hex, two digits each.
+    void push_hex(std::string_view bytes) {
+        self().ensure_fit(2 * bytes.size());
+        char* out = self().tail();
+        self().advance(
+            detail::write_hex(
+                out, reinterpret_cast<const unsigned char*>(bytes.data()),
+                bytes.size()) -
+            out);
+    }
+
+    /// @brief Append @p number as exactly `2 * sizeof(T)` lowercase hex
+    ///        digits (two's complement for negative values).
+    template <typename T,
+              typename = std::enable_if_t<std::is_integral<T>::value>>
+    SMALLSTRING_CONSTEXPR20 void push_hex(T number) {
+        self().ensure_fit(2 * sizeof(T));
+        char* out = self().tail();
+        self().advance(detail::write_hex_integer(out, number) - out);
+    }
+
+    /// @brief Append @p bytes as standard base64, with `=` padding.
+    void push_base64(std::string_view bytes) {
+        self().ensure_fit(detail::base64_length(bytes.size()));
+        char* out = self().tail();
+        self().advance(
+            detail::write_base64(
+                out, reinterpret_cast<const unsigned char*>(bytes.data()),
+                bytes.size()) -
+            out);
+    }
+
+    /**
+     * @brief Append @p number right-aligned in at least @p width characters.
+     *
+     * With the default `'0'` fill the sign precedes the zeros ("-0042");
+     * any other fill goes before the sign ("  -42").  Numbers wider than
+     * @p width are written in full, never truncated.
+     */
+    template <typename T,
+              typename = std::enable_if_t<std::is_integral<T>::value>>
+    SMALLSTRING_CONSTEXPR20 void push_padded(T number, std::size_t width,
+                                             char fill = '0') {
+        self().ensure_fit(detail::padded_length(number, width));
+        char* out = self().tail();
+        self().advance(detail::write_padded(out, number, width, fill) - out);
+    }
+
+    /**
+     * @brief Serialise @p count records with one reservation for the batch.
+     *
+     * @p serializer provides
+     *
+     * * `std::size_t max_size(const T&)` – an upper bound on the bytes one
+     *   record produces (sum the per-field bounds);
+     * * `void write(ReservedWriter<Derived>&, const T&)` – write a record
+     *   with the `push_unchecked` family.
+     *
+     * The bounds are summed, `ensure_fit` is called once and every record
+     * is written through a single `ReservedWriter`.
+     */
+    template <class T, class Serializer>
+    void push_records(const T* records, std::size_t count,
+                      Serializer&& serializer) {
+        std::size_t bound = 0;
+        for (std::size_t i = 0; i < count; i++)
+            bound += serializer.max_size(records[i]);
+        auto writer = reserve_writer(bound);
+        for (std::size_t i = 0; i < count; i++)
+            serializer.write(writer, records[i]);
+    }
+
+    /// @brief `push_records` over a contiguous container (vector, array).
+    template <class Container, class Serializer>
+    void push_records(const Container& records, Serializer&& serializer) {
+        push_records(std::data(records), std::size(records),
+                     std::forward<Serializer>(serializer));
+    }
+
+    /**
+     * @brief Append the cached, quoted JSON form of @p id from an
+     *        `InternTable` (intern.hpp) – one fixed-size copy for short
+     *        strings.
+     */
+    template <class Table>
+    void push_interned(const Table& table, typename Table::id_type id) {
+        table.push_json(self(), id);
+    }
+
+    /**
+     * @brief Reserve @p max_bytes once and return a `ReservedWriter` for
+     *        unchecked appends into them.
+     */
+    ReservedWriter<Derived> reserve_writer(std::size_t max_bytes) {
+        self().ensure_fit(max_bytes);
+        return ReservedWriter<Derived>(self(), max_bytes);
+    }
+};
+
 /**
  * @class Buffer
  * @brief Lightweight mutable byte buffer specialised for building strings.
  *
  * @tparam Alloc  `std::allocator<char>` by default; any STL-style allocator
  *                that allocates `char` is accepted.
+ * @tparam Growth Growth policy used when a push overflows the capacity
+ *                (`DoublingGrowth` by default, see `ExactGrowth`).
+ * @tparam Storage Storage policy owning the bytes (`VectorStorage` by
+ *                default, see `InlineStorage` / `InlineBuffer` and
+ *                `ReallocStorage`).
+ * @tparam Stats  Instrumentation policy (`NoStats` by default, see
+ *                `BufferStats` and stats.hpp's `SiteStats`).
  *
  * Typical usage
  * @code
@@ -48,41 +1123,98 @@ namespace smallstring {
  * @note  All offsets are tracked in **bytes**, *not* code-points.  The class
  *        is agnostic to encoding; treat it as raw bytes.
  */
-template <class Alloc = std::allocator<char>> class Buffer {
+template <class Alloc = std::allocator<char>, class Growth = DoublingGrowth,
+          class Storage = VectorStorage<Alloc>, class Stats = NoStats>
+class Buffer : public PushInterface<Buffer<Alloc, Growth, Storage, Stats>>,
+               private Stats {
   private:
-    std::size_t m_length = 0;          ///< Number of bytes currently used
-    std::vector<char, Alloc> m_buffer; ///< Backing storage
+    std::size_t m_begin = 0; ///< Offset of the first unconsumed byte
+    std::size_t m_end = 0;   ///< Offset one past the last written byte
+    Storage m_buffer;        ///< Backing storage
 
-    /**
-     * @brief Return the number of base-10 digits needed to print @p number.
-     *
-     * Handles negative values (adds one char for the sign) when the type is
-     * signed.
-     */
-    template <typename T,
-              typename = std::enable_if_t<std::is_integral<T>::value>>
-    std::size_t count_digits(T number) const {
-        std::size_t digits = 0;
-        if constexpr (std::is_signed<T>::value) {
-            if (number < 0)
-                digits = static_cast<T>(1);
-        }
-        while (number) {
-            number /= static_cast<T>(10);
-            ++digits;
-        }
-        return digits;
+    Stats& stats_policy() noexcept { return *this; }
+
+    /// @brief Report the current contents as a completed message.
+    void finish() noexcept {
+        if (m_end != m_begin)
+            stats_policy().on_finish(length());
+    }
+
+    /// @brief Slide the unconsumed bytes back to offset 0.
+    void compact() {
+        stats_policy().on_compact(m_end - m_begin);
+        std::copy(m_buffer.data() + m_begin, m_buffer.data() + m_end,
+                  m_buffer.data());
+        m_end -= m_begin;
+        m_begin = 0;
     }
 
   public:
+    using allocator_type = Alloc;
+
     /// @brief Construct the buffer with an initial @p capacity (bytes).
-    explicit Buffer(std::size_t capacity = 256) : m_buffer(capacity) {}
+    ///
+    /// The initial block is left uninitialised; only pushed bytes are written.
+    explicit Buffer(std::size_t capacity = Storage::default_capacity,
+                    const Alloc& alloc = Alloc())
+        : m_buffer(capacity, alloc) {}
 
-    Buffer(Buffer&& other) = default;
-    Buffer& operator=(Buffer&& other) = default;
+    /// @brief As above, with an initialised (stateful) stats policy.
+    Buffer(std::size_t capacity, const Alloc& alloc, const Stats& stats)
+        : Stats(stats), m_buffer(capacity, alloc) {}
 
-    Buffer(const Buffer&) = default;
-    Buffer& operator=(const Buffer&) = default;
+    /// @brief Steal @p other's storage; @p other is left empty but usable.
+    ///
+    /// Where the storage has to copy (inline bytes, unequal allocators),
+    /// only the unconsumed bytes are copied.
+    Buffer(Buffer&& other) noexcept(
+        std::is_nothrow_constructible<Storage, Storage&&, std::size_t,
+                                      std::size_t>::value)
+        : Stats(std::exchange(other.stats_policy(), Stats())),
+          m_begin(other.m_begin), m_end(other.m_end),
+          m_buffer(std::move(other.m_buffer), other.m_begin, other.m_end) {
+        other.m_begin = other.m_end = 0;
+    }
+
+    /// @brief Steal @p other's storage; @p other is left empty but usable.
+    Buffer& operator=(Buffer&& other) noexcept(noexcept(
+        std::declval<Storage&>().assign(std::declval<Storage&&>(),
+                                        std::size_t(), std::size_t()))) {
+        if (this != &other) {
+            finish();
+            m_begin = m_end = 0; // stays valid if the copy throws
+            m_buffer.assign(std::move(other.m_buffer), other.m_begin,
+                            other.m_end);
+            stats_policy() = std::exchange(other.stats_policy(), Stats());
+            m_begin = std::exchange(other.m_begin, 0);
+            m_end = std::exchange(other.m_end, 0);
+        }
+        return *this;
+    }
+
+    /// @brief Copy @p other's unconsumed bytes (only those, moved to the
+    ///        front) into storage of the same capacity.
+    Buffer(const Buffer& other)
+        : Stats(other.stats()), m_end(other.length()),
+          m_buffer(other.m_buffer, other.m_begin, other.m_end) {}
+
+    /// @brief Copy @p other's unconsumed bytes, reusing this buffer's
+    ///        storage when they fit.
+    Buffer& operator=(const Buffer& other) {
+        if (this != &other) {
+            finish();
+            m_begin = m_end = 0; // stays valid if the copy throws
+            m_buffer.assign(other.m_buffer, other.m_begin, other.m_end);
+            stats_policy() = other.stats();
+            m_end = other.length();
+        }
+        return *this;
+    }
+
+    ~Buffer() { finish(); }
+
+    /// @brief The stats policy's counters.
+    const Stats& stats() const noexcept { return *this; }
 
     /* --------------------------------------------------------------------- */
     /*                              Capacity API                             */
@@ -91,22 +1223,33 @@ template <class Alloc = std::allocator<char>> class Buffer {
     /// @brief Current capacity in bytes.
     std::size_t capacity() const { return m_buffer.size(); }
     /// @brief Bytes already written.
-    std::size_t length() const { return m_length; }
+    std::size_t length() const { return m_end - m_begin; }
     /// @brief Free space remaining before a resize is required.
     std::size_t remaining() const { return capacity() - length(); }
 
     /// @brief Discard all memory.
     void drop_memory() {
-        m_buffer.clear();
-        m_buffer.shrink_to_fit();
-        m_length = 0;
+        finish();
+        m_buffer.release();
+        m_begin = m_end = 0;
     }
 
     /// @brief Ensure another @p to_add bytes can be appended without resize.
+    ///
+    /// Bytes already consumed by `pop` are reclaimed first, by sliding the
+    /// contents back to the start of the storage; only if that is not enough
+    /// is the capacity grown, to the size chosen by the `Growth` policy, so
+    /// a run of small pushes reallocates O(log n) times rather than per push.
     void ensure_fit(const std::size_t to_add) {
-        const std::size_t new_capacity = m_length + to_add;
-        if (new_capacity > capacity()) {
-            m_buffer.resize(new_capacity);
+        if (m_end + to_add <= capacity())
+            return;
+        if (m_begin != 0)
+            compact();
+        const std::size_t required = m_end + to_add;
+        if (required > capacity()) {
+            const std::size_t old_capacity = capacity();
+            m_buffer.grow(Growth::grow(old_capacity, required), m_end);
+            stats_policy().on_grow(old_capacity, capacity(), m_end);
         }
     }
 
@@ -117,11 +1260,11 @@ template <class Alloc = std::allocator<char>> class Buffer {
     /*                         Raw pointer convenience                       */
     /* --------------------------------------------------------------------- */
 
-    char* head() { return m_buffer.data(); }
-    const char* head() const { return m_buffer.data(); }
+    char* head() { return m_buffer.data() + m_begin; }
+    const char* head() const { return m_buffer.data() + m_begin; }
 
-    char* tail() { return m_buffer.data() + m_length; }
-    const char* tail() const { return m_buffer.data() + m_length; }
+    char* tail() { return m_buffer.data() + m_end; }
+    const char* tail() const { return m_buffer.data() + m_end; }
 
     char* begin() { return head(); }
     const char* begin() const { return head(); }
@@ -130,80 +1273,78 @@ template <class Alloc = std::allocator<char>> class Buffer {
     const char* end() const { return tail(); }
 
     /// @brief Logical clear – the buffer’s capacity is unchanged.
-    void clear() { m_length = 0; }
-
-    /* --------------------------------------------------------------------- */
-    /*                            Push operations                            */
-    /* --------------------------------------------------------------------- */
-
-    /// @brief Append @p sz bytes starting at @p ptr.
-    void push(const char* ptr, std::size_t sz) {
-        ensure_fit(sz);
-        std::copy(ptr, ptr + sz, tail());
-        m_length += sz;
+    void clear() {
+        finish();
+        m_begin = m_end = 0;
     }
 
-    /// @brief Append a string literal (deduces size at compile time).
-    template <std::size_t N> void push(const char (&ptr)[N]) {
-        push(ptr, N - 1);
+    /// @brief Clear, and give memory back if the capacity exceeds
+    ///        @p capacity (e.g. a `SizeHint`'s) – for buffers reused across
+    ///        messages of very different sizes.
+    void clear(std::size_t capacity) {
+        clear();
+        if (this->capacity() > capacity) {
+            m_buffer.release();
+            ensure_fit(capacity);
+        }
     }
 
-    /// @brief Append the contents of a `std::string_view`.
-    void push(std::string_view view) { push(view.data(), view.length()); }
+    /// @brief Mark @p n bytes written directly at `tail()` as used.
+    ///
+    /// The bytes must have been reserved with `ensure_fit` beforehand.
+    void advance(std::size_t n) {
+        m_end += n;
+        stats_policy().on_length(length());
+    }
 
-    /// @brief Append the contents of a `std::string`.
-    void push(const std::string& str) { push(str.data(), str.length()); }
+    /// @brief Drop bytes from the end so that `length() == n` (no-op if
+    ///        already shorter).
+    void truncate(std::size_t n) {
+        if (n < length())
+            m_end = m_begin + n;
+    }
 
     /**
-     * @brief Append an integral value in base-10 with no allocations.
+     * @brief Open a length-prefixed frame at `tail()`.
+     *
+     * Reserves the largest header @p Encoding can produce for a @p T; push
+     * the body as usual, then `end()` the frame to write its length in
+     * place, with no copy of the body.
      *
-     * Handles signedness automatically.  The implementation writes digits
-     * right-to-left starting at `tail()`.
+     * @code
+     *   auto frame = buf.begin_frame<std::uint32_t>();
+     *   buf.push("{\"seq\":");
+     *   buf.push(seq);
+     *   buf.push("}");
+     *   frame.end(); // buf: 00 00 00 0b {"seq":...}
+     * @endcode
+     *
+     * @tparam T        Unsigned length type; bounds the body size.
+     * @tparam Encoding `FrameBigEndian` (default), `FrameLittleEndian`,
+     *                  `FrameVarint` or `FrameAscii`.
      */
-    template <typename T,
-              typename = std::enable_if_t<std::is_integral<T>::value>>
-    void push(T number) {
-        const auto ndigits = count_digits(number);
-
-        ensure_fit(ndigits);
-        m_length += ndigits;
-
-        char* start = tail();
-        start--;
-
-        bool negative = false;
-        if constexpr (std::is_signed<T>::value) {
-            negative = number < 0;
-            number = std::abs(number);
-        }
-
-        while (number) {
-            char digit = (number % 10) + '0';
-            *start-- = digit;
-            number /= 10;
-        }
-
-        if (negative)
-            *start = '-';
+    template <class T, class Encoding = FrameBigEndian>
+    [[nodiscard]] Frame<Buffer, T, Encoding> begin_frame() {
+        return Frame<Buffer, T, Encoding>(*this);
     }
 
-
     /* --------------------------------------------------------------------- */
     /*                            Pop operations                             */
     /* --------------------------------------------------------------------- */
 
     /**
-     * @brief Remove the first @p n bytes, closing the gap by memmoving.
+     * @brief Remove the first @p n bytes in O(1).
      *
-     * When @p n ≥ current length the buffer is simply cleared.
+     * Only the read offset moves; the consumed bytes are reclaimed lazily by
+     * `ensure_fit` when a push needs room at the tail.  When @p n ≥ current
+     * length the buffer is simply cleared.
      */
     void pop(const std::size_t n) {
-        if (n >= m_length) {
-            m_length = 0;
+        if (n >= length()) {
+            m_begin = m_end = 0;
             return;
         }
-        std::copy(head() + n, tail(), head());
-        m_length = m_length - n;
+        m_begin += n;
     }
 
     /* --------------------------------------------------------------------- */
@@ -213,20 +1354,70 @@ template <class Alloc = std::allocator<char>> class Buffer {
     /// @brief Return a view of the valid byte range `[head(), tail())`.
     [[nodiscard]] std::string_view view() const { return std::string_view(head(), length()); }
 
-    /// @brief Find overload – transparently forward to `std::string_view::find`.
+    /// @brief Find overload – see `find(std::string_view, std::size_t)`.
     std::size_t find(const char* str, std::size_t pos = 0UL) const {
-        return view().find(str, pos);
+        return find(std::string_view(str), pos);
     }
 
-    /// @brief Find overload – transparently forward to `std::string_view::find`.
+    /// @brief Find overload – see `find(std::string_view, std::size_t)`.
     std::size_t find(const std::string& str, std::size_t pos = 0UL) const {
-        return view().find(str, pos);
+        return find(std::string_view(str), pos);
     }
 
-    /// @brief Find overload – transparently forward to `std::string_view::find`.
+    /// @brief Offset of the first occurrence of @p str at or after @p pos,
+    ///        or `npos`; same result as `std::string_view::find`, but
+    ///        vectorised (see search.hpp).
     std::size_t find(std::string_view str, std::size_t pos = 0UL) const {
-        return view().find(str, pos);
+        return detail::find_in(view(), str, pos);
+    }
+
+    /// @brief Offset of the first @p ch at or after @p pos, or `npos`.
+    std::size_t find_byte(char ch, std::size_t pos = 0UL) const {
+        return detail::find_byte_in(view(), ch, pos);
+    }
+
+    /// @brief Offset of the first byte in @p set at or after @p pos, or
+    ///        `npos`.
+    std::size_t find_any_of(const ByteSet& set, std::size_t pos = 0UL) const {
+        return detail::find_any_of_in(view(), set, pos);
+    }
+
+    /// @brief `find_any_of` for a one-off set; prefer a reused `ByteSet`.
+    std::size_t find_any_of(std::string_view set,
+                            std::size_t pos = 0UL) const {
+        return find_any_of(ByteSet(set), pos);
+    }
+
+    /* --------------------------------------------------------------------- */
+    /*                               Comparison                              */
+    /* --------------------------------------------------------------------- */
+
+    /// @brief `std::string_view::compare` of the contents with @p other.
+    int compare(std::string_view other) const noexcept {
+        return detail::compare_bytes(view(), other);
+    }
+
+    /// @brief Same contents: lengths first, then a vectorised compare.
+    friend bool operator==(const Buffer& a, const Buffer& b) noexcept {
+        return a.length() == b.length() &&
+               detail::find_mismatch(a.head(), b.head(), a.length()) ==
+                   a.length();
+    }
+
+    friend bool operator!=(const Buffer& a, const Buffer& b) noexcept {
+        return !(a == b);
     }
 };
 
+/**
+ * @brief `Buffer` whose first @p N bytes are stored inline.
+ *
+ * Building a message that fits in @p N bytes never touches the allocator,
+ * so it can live on the stack or inside the owning struct; larger messages
+ * spill to @p Alloc transparently.
+ */
+template <std::size_t N, class Alloc = std::allocator<char>,
+          class Growth = DoublingGrowth, class Stats = NoStats>
+using InlineBuffer = Buffer<Alloc, Growth, InlineStorage<N, Alloc>, Stats>;
+
 } // namespace smallstring
\ No newline at end of file
@@ -0,0 +1,233 @@
+/**
+ * @file span_buffer.hpp
+ * @brief Non-owning buffer that formats straight into caller-supplied
+ *        memory (a shared-memory ring slot, an mmap'd log file, a stack
+ *        array) with the usual `push` API.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "smallstring.hpp"
+
+namespace smallstring {
+
+/* ------------------------------------------------------------------------- */
+/*                            Overflow policies                              */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * An overflow policy decides what a `SpanBuffer` does with a push that does
+ * not fit.  It must provide:
+ *
+ * * `static constexpr bool truncate` – whether a raw byte push is cut to
+ *   the remaining space instead of being dropped;
+ * * `bool flush(std::string_view pending)` – drain @p pending and return
+ *   true (the span is then reset), or return false to leave it untouched.
+ */
+
+/// @brief A push that does not fit is dropped whole.
+struct DropOverflow {
+    static constexpr bool truncate = false;
+    bool flush(std::string_view) { return false; }
+};
+
+/// @brief Raw bytes are cut to fit; a formatted push that does not fit is
+///        dropped.
+struct TruncateOverflow {
+    static constexpr bool truncate = true;
+    bool flush(std::string_view) { return false; }
+};
+
+/**
+ * @brief Hand the pending bytes to a callback and start over.
+ *
+ * Raw byte pushes larger than the whole span are passed to the callback
+ * directly instead of being copied.
+ */
+template <class Callback> struct FlushOverflow {
+    static constexpr bool truncate = false;
+    Callback callback; ///< Called as `callback(std::string_view)`
+
+    explicit FlushOverflow(Callback cb) : callback(std::move(cb)) {}
+
+    bool flush(std::string_view pending) {
+        if (!pending.empty())
+            callback(pending);
+        return true;
+    }
+};
+
+/* ------------------------------------------------------------------------- */
+/*                                SpanBuffer                                 */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @class SpanBuffer
+ * @brief Fixed-capacity writer over memory it does not own.
+ *
+ * @code
+ *   char* slot = ring.reserve(4096);             // caller's memory
+ *   smallstring::SpanBuffer out(slot, 4096);
+ *   out.push("px=");
+ *   out.push_fixed(px, 2);
+ *   if (!out.overflowed())
+ *       ring.commit(out.length());
+ *
+ *   // Or drain into a file whenever the span fills up:
+ *   smallstring::SpanBuffer log(page, sizeof(page),
+ *       smallstring::FlushOverflow([&](std::string_view bytes) {
+ *           ::write(fd, bytes.data(), bytes.size());
+ *       }));
+ * @endcode
+ *
+ * What happens when a push does not fit is up to the @p Overflow policy.
+ * Whenever bytes are dropped or truncated `overflowed()` becomes true and
+ * stays so until `clear()`.
+ */
+template <class Overflow = DropOverflow>
+class SpanBuffer : public PushInterface<SpanBuffer<Overflow>> {
+  private:
+    char* m_data;
+    std::size_t m_capacity;
+    std::size_t m_length = 0;
+    bool m_overflowed = false;
+    bool m_sinking = false;      ///< The current push goes to `m_discard`
+    bool m_dropping = false;     ///< ... and is being discarded
+    std::vector<char> m_discard; ///< Sink for pushes that do not fit
+    Overflow m_overflow;
+
+    using Base = PushInterface<SpanBuffer<Overflow>>;
+
+    /// @brief Try to flush; true if the span was drained.
+    bool drain() {
+        if (!m_overflow.flush(view()))
+            return false;
+        m_length = 0;
+        return true;
+    }
+
+  public:
+    /// @brief Write into the @p capacity bytes at @p data.
+    SpanBuffer(char* data, std::size_t capacity, Overflow overflow = Overflow())
+        : m_data(data), m_capacity(capacity), m_overflow(std::move(overflow)) {}
+
+    SpanBuffer(const SpanBuffer&) = delete;
+    SpanBuffer& operator=(const SpanBuffer&) = delete;
+
+    /* --------------------------------------------------------------------- */
+    /*                                Push API                               */
+    /* --------------------------------------------------------------------- */
+
+    using Base::push;
+
+    /// @brief Append @p sz bytes at @p ptr, subject to the overflow policy.
+    void push(const char* ptr, std::size_t sz) {
+        if (sz > remaining()) {
+            if (drain()) {
+                if (sz > m_capacity) {
+                    m_overflow.flush(std::string_view(ptr, sz));
+                    return;
+                }
+            } else {
+                m_overflowed = true;
+                if constexpr (!Overflow::truncate)
+                    return;
+                sz = remaining();
+            }
+        }
+        std::copy(ptr, ptr + sz, m_data + m_length);
+        m_length += sz;
+    }
+
+    /// @brief A string literal, subject to the overflow policy like other
+    ///        raw bytes (the inherited overload would bypass it).
+    template <std::size_t N> void push(const char (&ptr)[N]) {
+        push(ptr, N - 1);
+    }
+
+    void push(std::string_view view) { push(view.data(), view.length()); }
+    void push(const std::string& str) { push(str.data(), str.length()); }
+
+    /// @brief JSON-escaped @p str, kept or dropped whole.
+    ///
+    /// The generic `push_escaped` reserves run by run, which here would
+    /// let the runs before an overflow land; this reserves the worst case
+    /// once, so an oversized result goes to the sink and is dropped.
+    void push_escaped(std::string_view str) {
+        ensure_fit(str.size() * detail::max_json_escape_chars);
+        char* const out = tail();
+        advance(static_cast<std::size_t>(
+            detail::write_json_escaped(out, str.data(), str.size()) - out));
+    }
+
+    /**
+     * @brief Make @p n bytes writable at `tail()`.
+     *
+     * Formatted pushes reserve their worst case.  If that does not fit,
+     * the push is written to a scratch sink instead and copied in by
+     * `advance` if the bytes actually produced fit after all; otherwise
+     * they are dropped and `overflowed()` is set.
+     */
+    void ensure_fit(std::size_t n) {
+        m_sinking = false;
+        if (n <= remaining() || (drain() && n <= m_capacity))
+            return;
+        m_sinking = true;
+        m_dropping = false;
+        if (m_discard.size() < n)
+            m_discard.resize(n);
+    }
+
+    char* tail() { return m_sinking ? m_discard.data() : m_data + m_length; }
+
+    /// The bytes must have been reserved with `ensure_fit` beforehand.
+    void advance(std::size_t n) {
+        if (!m_sinking) {
+            m_length += n;
+        } else if (!m_dropping && n <= remaining()) {
+            std::copy(m_discard.data(), m_discard.data() + n,
+                      m_data + m_length);
+            m_length += n;
+        } else {
+            m_dropping = true;
+            m_overflowed = true;
+        }
+    }
+
+    /* --------------------------------------------------------------------- */
+    /*                                Read API                               */
+    /* --------------------------------------------------------------------- */
+
+    char* head() { return m_data; }
+    const char* head() const { return m_data; }
+
+    std::size_t length() const { return m_length; }
+    std::size_t capacity() const { return m_capacity; }
+    std::size_t remaining() const { return m_capacity - m_length; }
+
+    /// @brief True once any push was dropped or truncated.
+    bool overflowed() const { return m_overflowed; }
+
+    [[nodiscard]] std::string_view view() const {
+        return std::string_view(m_data, m_length);
+    }
+
+    /// @brief Hand the contents to the policy's flush, if it has one.
+    void flush() { drain(); }
+
+    /// @brief Forget the contents and the overflow flag.
+    void clear() {
+        m_length = 0;
+        m_overflowed = false;
+    }
+
+    Overflow& overflow_policy() { return m_overflow; }
+};
+
+} // namespace smallstring
@@ -0,0 +1,84 @@
+/**
+ * @file static_buffer.hpp
+ * @brief A fixed-capacity buffer that can build messages at compile time.
+ *
+ * Heartbeats, logon acks and canned error bodies never change, yet are
+ * usually rebuilt on every send.  With C++20, `StaticBuffer` runs the text
+ * and integer `push` overloads in constant evaluation, so such a message
+ * can be a `constexpr` object living in `.rodata` and sent as one
+ * `string_view`; a message with a constant prefix can start from a
+ * `constexpr` buffer that is copied in at runtime.  Before C++20 it is an
+ * ordinary fixed-capacity, never-allocating buffer.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string_view>
+
+#include "smallstring.hpp"
+
+namespace smallstring {
+
+/**
+ * @class StaticBuffer
+ * @brief At most @p N bytes, stored inline; pushing more throws
+ *        `std::length_error` (a compile error in constant evaluation).
+ *
+ * @code
+ *   constexpr auto heartbeat =
+ *       smallstring::make_static_buffer<32>("35=0|34=", 1, "|");
+ *   static_assert(heartbeat.view() == "35=0|34=1|");
+ *   socket.send(heartbeat.view());
+ *
+ *   constexpr auto prefix = smallstring::make_static_buffer<16>(
+ *       R"({"type":"fill","v":)", 2, ",");
+ *   buf.push(prefix.view()); // one memcpy, then the runtime fields
+ * @endcode
+ *
+ * Only the overloads marked `SMALLSTRING_CONSTEXPR20` (text, integers,
+ * `push_hex` / `push_padded` of integers) are usable at compile time;
+ * floating point and the vectorised encoders are runtime only.
+ */
+template <std::size_t N>
+class StaticBuffer : public PushInterface<StaticBuffer<N>> {
+    static_assert(N > 0, "StaticBuffer needs a non-zero capacity");
+
+  private:
+    char m_data[N] = {}; ///< Initialised, as a constant expression requires
+    std::size_t m_length = 0;
+
+  public:
+    constexpr StaticBuffer() = default;
+
+    /// @name Write-side primitives used by `PushInterface`.
+    /// @{
+    constexpr void ensure_fit(std::size_t n) const {
+        if (n > N - m_length)
+            throw std::length_error("StaticBuffer capacity exceeded");
+    }
+    constexpr char* tail() { return m_data + m_length; }
+    constexpr void advance(std::size_t n) { m_length += n; }
+    /// @}
+
+    static constexpr std::size_t capacity() { return N; }
+    constexpr std::size_t length() const { return m_length; }
+    constexpr std::size_t remaining() const { return N - m_length; }
+    constexpr const char* head() const { return m_data; }
+    constexpr std::string_view view() const {
+        return std::string_view(m_data, m_length);
+    }
+    constexpr void clear() { m_length = 0; }
+};
+
+/// @brief A `StaticBuffer<N>` holding each of @p parts pushed in order.
+template <std::size_t N, class... Parts>
+SMALLSTRING_CONSTEXPR20 StaticBuffer<N>
+make_static_buffer(const Parts&... parts) {
+    StaticBuffer<N> buffer;
+    (buffer.push(parts), ...);
+    return buffer;
+}
+
+} // namespace smallstring
@@ -0,0 +1,169 @@
+/**
+ * @file stats.hpp
+ * @brief Process-wide buffer statistics aggregated per tag.
+ *
+ * `SiteStats<Tag>` is a `Buffer` stats policy that reports into a registry
+ * entry shared by every buffer with the same @p Tag – typically one tag per
+ * call site or message type:
+ *
+ * @code
+ *   SMALLSTRING_STATS_TAG(QuoteSite, "quote");
+ *   using QuoteBuffer = smallstring::Buffer<
+ *       std::allocator<char>, smallstring::DoublingGrowth,
+ *       smallstring::VectorStorage<>, smallstring::SiteStats<QuoteSite>>;
+ *
+ *   // later, e.g. from an admin endpoint
+ *   smallstring::StatsRegistry::instance().for_each(
+ *       [](const char* name, const smallstring::StatsCounters& c) {
+ *           log(name, c.messages, c.resizes, c.percentile(0.99));
+ *       });
+ * @endcode
+ *
+ * Growth and completed messages cost one relaxed atomic add each; appends
+ * only update a per-buffer peak.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include "smallstring.hpp"
+
+namespace smallstring {
+
+/**
+ * @class StatsRegistry
+ * @brief Process-wide list of `SiteStats` entries, one per tag.
+ */
+class StatsRegistry {
+  public:
+    /// @brief Shared counters for one tag.
+    struct Entry {
+        const char* name;
+        std::atomic<std::uint64_t> resizes{0};
+        std::atomic<std::uint64_t> bytes_copied{0};
+        std::atomic<std::uint64_t> peak_length{0};
+        std::atomic<std::uint64_t> messages{0};
+        std::atomic<std::uint64_t> size_histogram[StatsCounters::buckets] = {};
+        Entry* next = nullptr;
+
+        explicit Entry(const char* tag_name) : name(tag_name) {
+            StatsRegistry::instance().add(*this);
+        }
+
+        Entry(const Entry&) = delete;
+        Entry& operator=(const Entry&) = delete;
+
+        /// @brief A consistent-enough copy of the counters.
+        StatsCounters snapshot() const noexcept {
+            StatsCounters counters;
+            counters.resizes = resizes.load(std::memory_order_relaxed);
+            counters.bytes_copied =
+                bytes_copied.load(std::memory_order_relaxed);
+            counters.peak_length = peak_length.load(std::memory_order_relaxed);
+            counters.messages = messages.load(std::memory_order_relaxed);
+            for (std::size_t k = 0; k < StatsCounters::buckets; k++)
+                counters.size_histogram[k] =
+                    size_histogram[k].load(std::memory_order_relaxed);
+            return counters;
+        }
+
+        void reset() noexcept {
+            resizes.store(0, std::memory_order_relaxed);
+            bytes_copied.store(0, std::memory_order_relaxed);
+            peak_length.store(0, std::memory_order_relaxed);
+            messages.store(0, std::memory_order_relaxed);
+            for (auto& bucket : size_histogram)
+                bucket.store(0, std::memory_order_relaxed);
+        }
+    };
+
+    static StatsRegistry& instance() {
+        static StatsRegistry registry;
+        return registry;
+    }
+
+    /// @brief Call `fn(const char* name, const StatsCounters&)` per tag.
+    template <class Fn> void for_each(Fn&& fn) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const Entry* entry = m_entries; entry; entry = entry->next)
+            fn(entry->name, entry->snapshot());
+    }
+
+    /// @brief Zero every entry's counters.
+    void reset() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (Entry* entry = m_entries; entry; entry = entry->next)
+            entry->reset();
+    }
+
+  private:
+    mutable std::mutex m_mutex;
+    Entry* m_entries = nullptr;
+
+    StatsRegistry() = default;
+
+    void add(Entry& entry) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        entry.next = m_entries;
+        m_entries = &entry;
+    }
+};
+
+/**
+ * @brief Stats policy aggregating into the registry entry for @p Tag.
+ *
+ * @p Tag must provide `static constexpr const char* name`; see
+ * `SMALLSTRING_STATS_TAG`.
+ */
+template <class Tag> class SiteStats {
+  private:
+    std::size_t m_peak = 0; ///< Peak length of the current message
+
+    static StatsRegistry::Entry& entry() {
+        static StatsRegistry::Entry site(Tag::name);
+        return site;
+    }
+
+  public:
+    /// @brief The aggregated counters for @p Tag.
+    static StatsCounters counters() { return entry().snapshot(); }
+
+    void on_grow(std::size_t, std::size_t, std::size_t copied) noexcept {
+        entry().resizes.fetch_add(1, std::memory_order_relaxed);
+        entry().bytes_copied.fetch_add(copied, std::memory_order_relaxed);
+    }
+
+    void on_compact(std::size_t copied) noexcept {
+        entry().bytes_copied.fetch_add(copied, std::memory_order_relaxed);
+    }
+
+    void on_length(std::size_t length) noexcept {
+        if (length > m_peak)
+            m_peak = length;
+    }
+
+    void on_finish(std::size_t length) noexcept {
+        StatsRegistry::Entry& site = entry();
+        site.messages.fetch_add(1, std::memory_order_relaxed);
+        site.size_histogram[StatsCounters::bucket(length)].fetch_add(
+            1, std::memory_order_relaxed);
+        std::uint64_t peak = site.peak_length.load(std::memory_order_relaxed);
+        while (m_peak > peak &&
+               !site.peak_length.compare_exchange_weak(
+                   peak, m_peak, std::memory_order_relaxed))
+            ;
+        m_peak = 0;
+    }
+};
+
+} // namespace smallstring
+
+/// @brief Declare a `SiteStats` tag type @p Tag reported as @p label.
+#define SMALLSTRING_STATS_TAG(Tag, label)                                      \
+    struct Tag {                                                               \
+        static constexpr const char* name = label;                             \
+    }
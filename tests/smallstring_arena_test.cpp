@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include <smallstring/arena.hpp>
+#include <smallstring/smallstring.hpp>
+
+using ArenaBuffer = smallstring::Buffer<smallstring::ArenaAllocator<char>>;
+using ArenaInlineBuffer =
+    smallstring::InlineBuffer<16, smallstring::ArenaAllocator<char>>;
+
+TEST(smallstring_arena_test, allocations_are_aligned_and_owned) {
+    smallstring::Arena arena(1024);
+    void* a = arena.allocate(3, 1);
+    void* b = arena.allocate(8, 8);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(b) % 8, 0UL);
+    EXPECT_TRUE(arena.owns(a));
+    EXPECT_TRUE(arena.owns(b));
+
+    int local = 0;
+    EXPECT_FALSE(arena.owns(&local));
+
+    // Oversized requests get a block of their own.
+    void* big = arena.allocate(4096);
+    EXPECT_TRUE(arena.owns(big));
+}
+
+TEST(smallstring_arena_test, padding_past_the_block_end_moves_on) {
+    alignas(16) char storage[40];
+    smallstring::Arena arena(storage, sizeof(storage), 1024);
+    arena.allocate(37, 1);
+    // Aligning the cursor to 16 would step past the end of the block.
+    char* next = static_cast<char*>(arena.allocate(8, 16));
+    EXPECT_TRUE(next < storage || next >= storage + sizeof(storage));
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(next) % 16, 0UL);
+    EXPECT_TRUE(arena.owns(next));
+}
+
+TEST(smallstring_arena_test, last_allocation_is_rolled_back) {
+    smallstring::Arena arena(1024);
+    void* a = arena.allocate(32, 1);
+    arena.deallocate(a, 32);
+    EXPECT_EQ(arena.allocate(32, 1), a);
+}
+
+TEST(smallstring_arena_test, reset_reuses_memory) {
+    alignas(std::max_align_t) char storage[256];
+    smallstring::Arena arena(storage, sizeof(storage), 1024);
+    void* first = arena.allocate(64);
+    EXPECT_EQ(first, static_cast<void*>(storage));
+
+    void* spilled = arena.allocate(512);
+    EXPECT_TRUE(arena.owns(spilled));
+
+    arena.reset();
+    EXPECT_FALSE(arena.owns(spilled));
+    EXPECT_EQ(arena.allocate(64), first);
+    // The heap block was kept as a spare and is handed out again.
+    EXPECT_EQ(arena.allocate(512), spilled);
+}
+
+TEST(smallstring_arena_test, buffer_draws_from_arena) {
+    smallstring::Arena arena;
+    {
+        ArenaBuffer buf(16, arena);
+        buf.push(std::string(1000, 'x'));
+        buf.push(42);
+        EXPECT_TRUE(arena.owns(buf.head()));
+        EXPECT_EQ(buf.length(), 1002UL);
+        EXPECT_EQ(buf.view().substr(1000), "42");
+    }
+    arena.reset();
+}
+
+TEST(smallstring_arena_test, assignment_keeps_each_buffer_in_its_arena) {
+    smallstring::Arena left_arena, right_arena;
+    {
+        ArenaBuffer left(16, left_arena);
+        ArenaBuffer right(16, right_arena);
+        left.push("left side");
+        right.push(std::string(100, 'r'));
+
+        left = right;
+        EXPECT_EQ(left.view(), right.view());
+        EXPECT_TRUE(left_arena.owns(left.head()));
+
+        right.push("!");
+        left = std::move(right);
+        EXPECT_EQ(left.view(), std::string(100, 'r') + "!");
+        EXPECT_TRUE(left_arena.owns(left.head()));
+    }
+    {
+        ArenaInlineBuffer left(16, left_arena);
+        ArenaInlineBuffer right(16, right_arena);
+        right.push(std::string(100, 'r'));
+
+        left = right;
+        EXPECT_EQ(left.view(), std::string(100, 'r'));
+        EXPECT_TRUE(left_arena.owns(left.head()));
+
+        left = std::move(right);
+        EXPECT_EQ(left.view(), std::string(100, 'r'));
+        EXPECT_TRUE(left_arena.owns(left.head()));
+
+        ArenaInlineBuffer moved(std::move(left));
+        EXPECT_EQ(moved.view(), std::string(100, 'r'));
+        EXPECT_TRUE(left_arena.owns(moved.head()));
+    }
+    {
+        ArenaBuffer left(16, left_arena);
+        ArenaBuffer right(16, right_arena);
+        left.push(std::string(50, 'l'));
+        right.push(std::string(60, 'r'));
+        std::swap(left, right);
+        EXPECT_EQ(left.view(), std::string(60, 'r'));
+        EXPECT_EQ(right.view(), std::string(50, 'l'));
+        EXPECT_TRUE(left_arena.owns(left.head()));
+        EXPECT_TRUE(right_arena.owns(right.head()));
+    }
+}
+
+TEST(smallstring_arena_test, moves_between_arenas_copy_unconsumed_bytes) {
+    smallstring::Arena left_arena, right_arena;
+    for (const bool popped : {false, true}) {
+        ArenaInlineBuffer left(16, left_arena);
+        ArenaInlineBuffer right(16, right_arena);
+        right.push(std::string(100, 'r'));
+        right.push("tail");
+        right.pop(popped ? 100 : 0);
+        const std::string expected(right.view());
+
+        left = std::move(right);
+        EXPECT_EQ(left.view(), expected);
+        EXPECT_TRUE(left_arena.owns(left.head()));
+        EXPECT_EQ(right.length(), 0u);
+    }
+}
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include <smallstring/async_sink.hpp>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+using Sink = smallstring::AsyncSink<>;
+
+class smallstring_async_sink_test
+    : public ::testing::TestWithParam<Sink::Backend> {};
+
+std::string read_all(int fd) {
+    std::string out;
+    char chunk[4096];
+    for (ssize_t n; (n = ::read(fd, chunk, sizeof(chunk))) > 0;)
+        out.append(chunk, static_cast<std::size_t>(n));
+    return out;
+}
+
+/// Writes @p batches of numbered lines through @p sink; returns the bytes.
+std::string write_batches(Sink& sink, int batches, int lines,
+                          std::size_t depth) {
+    std::string expected;
+    for (int batch = 0; batch < batches; batch++) {
+        auto buf = sink.acquire();
+        for (int line = 0; line < lines; line++) {
+            buf->push(batch);
+            buf->push(".");
+            buf->push(line);
+            buf->push("\n");
+        }
+        expected += buf->view();
+        sink.submit(std::move(buf));
+        EXPECT_LE(sink.pending(), depth);
+    }
+    return expected;
+}
+
+} // namespace
+
+TEST_P(smallstring_async_sink_test, writes_file_in_order) {
+    char path[] = "/tmp/smallstring_sink_XXXXXX";
+    const int fd = ::mkstemp(path);
+    ASSERT_GE(fd, 0);
+    ::unlink(path);
+
+    smallstring::BufferPool<> pool(256);
+    std::string expected;
+    {
+        Sink sink(fd, pool, 2, GetParam());
+        expected = write_batches(sink, 50, 40, 2);
+        sink.flush();
+        EXPECT_EQ(sink.pending(), 0u);
+        EXPECT_EQ(sink.bytes_written(), expected.size());
+    }
+    ASSERT_EQ(::lseek(fd, 0, SEEK_SET), 0);
+    EXPECT_EQ(read_all(fd), expected);
+    // Written buffers were handed back to the pool.
+    EXPECT_GT(pool.stats().hits, 0u);
+    ::close(fd);
+}
+
+TEST_P(smallstring_async_sink_test, writes_slow_socket_with_short_writes) {
+    int fds[2];
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    const int small = 4096;
+    ::setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &small, sizeof(small));
+
+    std::string received;
+    std::thread reader([&] { received = read_all(fds[1]); });
+
+    smallstring::BufferPool<> pool(256);
+    std::string expected;
+    {
+        Sink sink(fds[0], pool, 3, GetParam());
+        expected = write_batches(sink, 40, 500, 3);
+        smallstring::Buffer<> extra;
+        extra.push("tail\n");
+        expected += "tail\n";
+        sink.submit(std::move(extra));
+    } // the destructor flushes
+    EXPECT_EQ(::fcntl(fds[0], F_GETFL) & O_NONBLOCK, 0);
+    ::close(fds[0]);
+    reader.join();
+    ::close(fds[1]);
+    EXPECT_EQ(received, expected);
+}
+
+TEST_P(smallstring_async_sink_test, reports_write_errors) {
+    const int fd = ::open("/dev/null", O_RDONLY);
+    ASSERT_GE(fd, 0);
+    smallstring::BufferPool<> pool;
+    Sink sink(fd, pool, 2, GetParam());
+    auto buf = sink.acquire();
+    buf->push("lost");
+    EXPECT_THROW(
+        {
+            sink.submit(std::move(buf));
+            sink.flush();
+        },
+        std::system_error);
+    ::close(fd);
+}
+
+TEST_P(smallstring_async_sink_test, reports_backend_in_use) {
+    int fds[2];
+    ASSERT_EQ(::pipe(fds), 0);
+    smallstring::BufferPool<> pool;
+    {
+        Sink sink(fds[1], pool, 2, GetParam());
+        if (GetParam() == Sink::Backend::automatic)
+            EXPECT_NE(sink.backend(), Sink::Backend::automatic);
+        else
+            EXPECT_EQ(sink.backend(), GetParam());
+    }
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+INSTANTIATE_TEST_SUITE_P(backends, smallstring_async_sink_test,
+                         ::testing::Values(Sink::Backend::automatic,
+                                           Sink::Backend::epoll),
+                         [](const auto& info) {
+                             return std::string(
+                                 info.param == Sink::Backend::epoll
+                                     ? "epoll"
+                                     : "automatic");
+                         });
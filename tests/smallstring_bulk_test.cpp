@@ -0,0 +1,109 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <smallstring/bulk.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Trade {
+    std::uint64_t id;
+    std::string symbol;
+    double px;
+    std::int64_t qty;
+};
+
+struct TradeSerializer {
+    std::size_t max_size(const Trade& trade) const {
+        return sizeof("{\"id\":,\"sym\":\"\",\"px\":,\"qty\":}\n") +
+               smallstring::max_chars<std::uint64_t> +
+               smallstring::max_escaped_chars(trade.symbol.size()) +
+               smallstring::max_fixed_chars(trade.px, 2) +
+               smallstring::max_chars<std::int64_t>;
+    }
+
+    template <class Writer> void write(Writer& w, const Trade& trade) const {
+        w.push_unchecked("{\"id\":");
+        w.push_unchecked(trade.id);
+        w.push_unchecked(",\"sym\":\"");
+        w.push_escaped_unchecked(trade.symbol);
+        w.push_unchecked("\",\"px\":");
+        w.push_fixed_unchecked(trade.px, 2);
+        w.push_unchecked(",\"qty\":");
+        w.push_unchecked(trade.qty);
+        w.push_unchecked("}\n");
+    }
+};
+
+/// Fails on one trade, deep inside a worker's chunk.
+struct ThrowingSerializer : TradeSerializer {
+    template <class Writer> void write(Writer& w, const Trade& trade) const {
+        if (trade.id == 1000 + 7777)
+            throw std::runtime_error("bad trade");
+        TradeSerializer::write(w, trade);
+    }
+};
+
+std::vector<Trade> make_trades(std::size_t count) {
+    std::vector<Trade> trades;
+    for (std::size_t i = 0; i < count; i++) {
+        trades.push_back({1000 + i, i % 5 ? "AAPL" : "A\"B",
+                          100.0 + static_cast<double>(i) / 8,
+                          static_cast<std::int64_t>(i) - 50});
+    }
+    return trades;
+}
+
+std::string per_field(const std::vector<Trade>& trades) {
+    smallstring::Buffer<> buffer;
+    for (const Trade& trade : trades) {
+        buffer.push("{\"id\":");
+        buffer.push(trade.id);
+        buffer.push(",\"sym\":\"");
+        buffer.push_escaped(trade.symbol);
+        buffer.push("\",\"px\":");
+        buffer.push_fixed(trade.px, 2);
+        buffer.push(",\"qty\":");
+        buffer.push(trade.qty);
+        buffer.push("}\n");
+    }
+    return std::string(buffer.view());
+}
+
+} // namespace
+
+TEST(smallstring_bulk_test, push_records_matches_per_field_pushes) {
+    const auto trades = make_trades(100);
+    smallstring::Buffer<> buffer(16);
+    buffer.push("[batch]\n");
+    buffer.push_records(trades, TradeSerializer{});
+    EXPECT_EQ(buffer.view(), "[batch]\n" + per_field(trades));
+    EXPECT_EQ(buffer.view().substr(8, 47),
+              "{\"id\":1000,\"sym\":\"A\\\"B\",\"px\":100.00,\"qty\":-50}\n");
+}
+
+TEST(smallstring_bulk_test, parallel_chunks_are_concatenated_in_order) {
+    const auto trades = make_trades(10000);
+    smallstring::Buffer<> buffer;
+    smallstring::push_records_parallel(buffer, trades, TradeSerializer{}, 4,
+                                       100);
+    EXPECT_EQ(buffer.view(), per_field(trades));
+
+    // A batch below one chunk stays on this thread.
+    smallstring::Buffer<> small;
+    smallstring::push_records_parallel(small, make_trades(10),
+                                       TradeSerializer{});
+    EXPECT_EQ(small.view(), per_field(make_trades(10)));
+}
+
+TEST(smallstring_bulk_test, parallel_serializer_errors_are_rethrown) {
+    const auto trades = make_trades(10000);
+    smallstring::Buffer<> buffer;
+    buffer.push("kept");
+    EXPECT_THROW(smallstring::push_records_parallel(buffer, trades,
+                                                    ThrowingSerializer{}, 4,
+                                                    100),
+                 std::runtime_error);
+    EXPECT_EQ(buffer.view(), "kept");
+}
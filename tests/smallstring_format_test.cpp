@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include <smallstring/format.hpp>
+#include <smallstring/smallstring.hpp>
+#include <smallstring/span_buffer.hpp>
+#include <string>
+
+namespace {
+struct QuotePattern {
+    static constexpr std::string_view value() {
+        return "{\"sym\":\"{}\",\"px\":{},\"qty\":{}}";
+    }
+};
+} // namespace
+
+TEST(smallstring_format_test, pattern_type) {
+    smallstring::Buffer buf(8);
+    smallstring::format<QuotePattern>(buf, "AAPL", 101.25, 300);
+    EXPECT_EQ(buf.view(), R"({"sym":"AAPL","px":101.25,"qty":300})");
+}
+
+TEST(smallstring_format_test, macro_formats_mixed_arguments) {
+    smallstring::Buffer buf;
+    const std::string name = "x";
+    SMALLSTRING_FORMAT(buf, "{}={} ({}, {})", name, -42, 0.5f,
+                       std::string_view("tail"));
+    SMALLSTRING_FORMAT(buf, "|{}{}|", static_cast<unsigned char>(7),
+                       INT64_MIN);
+    EXPECT_EQ(buf.view(), "x=-42 (0.5, tail)|7-9223372036854775808|");
+}
+
+TEST(smallstring_format_test, only_placeholders_or_only_literals) {
+    smallstring::Buffer buf;
+    SMALLSTRING_FORMAT(buf, "{}", 1);
+    SMALLSTRING_FORMAT(buf, "{}{}", 2, 3);
+    SMALLSTRING_FORMAT(buf, "heartbeat");
+    SMALLSTRING_FORMAT(buf, "{\"}\"{}", "");
+    EXPECT_EQ(buf.view(), "123heartbeat{\"}\"");
+}
+
+TEST(smallstring_format_test, works_with_span_buffer) {
+    char storage[8];
+    smallstring::SpanBuffer out(storage, sizeof(storage));
+    // The worst-case bound exceeds the span but the output fits.
+    SMALLSTRING_FORMAT(out, "[{},{}]", 1, 2);
+    EXPECT_EQ(out.view(), "[1,2]");
+    EXPECT_FALSE(out.overflowed());
+}
+
+#if __cplusplus >= 202002L && defined(__cpp_nontype_template_args) &&          \
+    __cpp_nontype_template_args >= 201911L
+TEST(smallstring_format_test, string_template_argument) {
+    smallstring::Buffer buf;
+    smallstring::format<"{\"id\":{},\"px\":{}}">(buf, 7, 1.5);
+    EXPECT_EQ(buf.view(), R"({"id":7,"px":1.5})");
+}
+#endif
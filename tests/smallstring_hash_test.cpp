@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <smallstring/hashed.hpp>
+#include <string>
+#include <unordered_set>
+
+TEST(smallstring_hash_test, known_value_and_lengths) {
+    // wyhash final 4.2 reference value for the empty string, seed 0.
+    EXPECT_EQ(smallstring::hash_bytes(""), 0x93228a4de0eec5a2ULL);
+    std::unordered_set<std::uint64_t> seen;
+    std::string text;
+    for (int i = 0; i < 300; i++) {
+        seen.insert(smallstring::hash_bytes(text));
+        text += static_cast<char>('a' + i % 26);
+    }
+    EXPECT_EQ(seen.size(), 300u);
+    EXPECT_NE(smallstring::hash_bytes("abc", 1),
+              smallstring::hash_bytes("abc"));
+}
+
+TEST(smallstring_hash_test, incremental_matches_one_shot) {
+    smallstring::HashedBuffer<> buffer;
+    std::string expected;
+    for (int i = 0; i < 400; i++) {
+        if (i % 3 == 0) {
+            buffer.push(i);
+            expected += std::to_string(i);
+        } else {
+            buffer.push(",key");
+            expected += ",key";
+        }
+        ASSERT_EQ(buffer.hash(), smallstring::hash_bytes(expected)) << i;
+    }
+    buffer.pop(37);
+    EXPECT_EQ(buffer.hash(), smallstring::hash_bytes(expected.substr(37)));
+    buffer.push_escaped("tail \"quoted\"");
+    EXPECT_EQ(buffer.hash(), smallstring::hash_bytes(buffer.view()));
+    buffer.clear();
+    EXPECT_EQ(buffer.hash(), smallstring::hash_bytes(""));
+}
+
+TEST(smallstring_hash_test, equality_and_compare) {
+    smallstring::HashedBuffer<> a, b;
+    const std::string body(100, 'x');
+    a.push(body);
+    b.push(body);
+    EXPECT_TRUE(a == b);
+    a.push("1");
+    b.push("2");
+    EXPECT_TRUE(a != b);
+    EXPECT_LT(a.compare(b.view()), 0);
+    EXPECT_GT(b.compare(a.view()), 0);
+    EXPECT_EQ(a.compare(a.view()), 0);
+
+    std::unordered_set<smallstring::HashedBuffer<>> cache;
+    cache.insert(a);
+    EXPECT_EQ(cache.count(a), 1u);
+    EXPECT_EQ(cache.count(b), 0u);
+}
+
+TEST(smallstring_hash_test, buffer_compare_finds_every_mismatch) {
+    std::string base(70, 'q');
+    smallstring::Buffer<> reference;
+    reference.push(base);
+    for (std::size_t at = 0; at < base.size(); at++) {
+        std::string other = base;
+        other[at] = '\xf0'; // above 'q' when compared unsigned
+        smallstring::Buffer<> changed;
+        changed.push(other);
+        ASSERT_FALSE(reference == changed) << at;
+        ASSERT_LT(reference.compare(changed.view()), 0) << at;
+        ASSERT_GT(changed.compare(reference.view()), 0) << at;
+    }
+    smallstring::Buffer<> same;
+    same.push(base);
+    EXPECT_TRUE(reference == same);
+    EXPECT_LT(reference.compare(base + "!"), 0);
+    EXPECT_GT(reference.compare(base.substr(1)), 0);
+}
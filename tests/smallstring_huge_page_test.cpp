@@ -0,0 +1,72 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <smallstring/huge_page.hpp>
+#include <string>
+#include <utility>
+
+namespace {
+
+constexpr std::size_t threshold = 64 * 1024;
+
+std::string pattern(std::size_t n) {
+    std::string out(n, '\0');
+    for (std::size_t i = 0; i < n; i++)
+        out[i] = static_cast<char>('a' + i % 23);
+    return out;
+}
+
+} // namespace
+
+TEST(smallstring_huge_page_test, allocator_maps_large_blocks) {
+    using Alloc = smallstring::HugePageAllocator<char, threshold>;
+    Alloc alloc;
+    EXPECT_FALSE(Alloc::is_mapped(threshold - 1));
+    EXPECT_TRUE(Alloc::is_mapped(threshold));
+
+    char* small = alloc.allocate(100);
+    std::memset(small, 'x', 100);
+    small = alloc.reallocate(small, 100, 3 << 20, 100);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(small) % (2 << 20), 0u);
+    EXPECT_EQ(std::string(small, 100), std::string(100, 'x'));
+
+    const std::string bytes = pattern(3 << 20);
+    std::memcpy(small, bytes.data(), bytes.size());
+    char* grown = alloc.reallocate(small, 3 << 20, 40 << 20, bytes.size());
+    EXPECT_EQ(std::string(grown, bytes.size()), bytes);
+    grown[(40 << 20) - 1] = 'z';
+    alloc.deallocate(grown, 40 << 20);
+}
+
+TEST(smallstring_huge_page_test, buffer_grows_across_the_threshold) {
+    smallstring::HugePageBuffer<threshold> buffer(16);
+    const std::string bytes = pattern(5 << 20);
+    for (std::size_t at = 0; at < bytes.size(); at += 1000)
+        buffer.push(std::string_view(bytes).substr(at, 1000));
+    EXPECT_EQ(buffer.view(), bytes);
+    EXPECT_GE(buffer.capacity(), bytes.size());
+
+    buffer.pop(12345);
+    buffer.push("tail");
+    EXPECT_EQ(buffer.view(), bytes.substr(12345) + "tail");
+
+    smallstring::HugePageBuffer<threshold> copy(buffer);
+    EXPECT_EQ(copy.view(), buffer.view());
+    smallstring::HugePageBuffer<threshold> moved(std::move(copy));
+    EXPECT_EQ(moved.view(), buffer.view());
+    EXPECT_EQ(copy.length(), 0u);
+    copy = moved;
+    EXPECT_EQ(copy.view(), buffer.view());
+
+    buffer.drop_memory();
+    EXPECT_EQ(buffer.capacity(), 0u);
+    buffer.push("again");
+    EXPECT_EQ(buffer.view(), "again");
+}
+
+TEST(smallstring_huge_page_test, works_as_a_vector_storage_allocator) {
+    smallstring::Buffer<smallstring::HugePageAllocator<char, threshold, true>>
+        buffer;
+    const std::string bytes = pattern(1 << 20);
+    buffer.push(bytes);
+    EXPECT_EQ(buffer.view(), bytes);
+}
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include <smallstring/intern.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(smallstring_intern_test, ids_are_dense_and_stable) {
+    smallstring::InternTable<> table;
+    std::vector<std::string> names;
+    for (int i = 0; i < 5000; i++)
+        names.push_back("SYM" + std::to_string(i * 7919));
+    for (std::size_t i = 0; i < names.size(); i++)
+        ASSERT_EQ(table.intern(names[i]), i);
+    EXPECT_EQ(table.size(), names.size());
+    // Views survive growth.
+    const std::string_view first = table.name(0);
+    for (std::size_t i = 0; i < names.size(); i++) {
+        ASSERT_EQ(table.intern(names[i]), i);
+        ASSERT_EQ(table.find(names[i]), i);
+        ASSERT_EQ(table.name(static_cast<std::uint32_t>(i)), names[i]);
+    }
+    EXPECT_EQ(first.data(), table.name(0).data());
+    EXPECT_EQ(table.find("missing"), table.npos);
+    EXPECT_EQ(table.find(""), table.npos);
+    EXPECT_EQ(table.intern(""), names.size());
+}
+
+TEST(smallstring_intern_test, push_interned_writes_escaped_json) {
+    smallstring::InternTable<> table(4);
+    const auto plain = table.intern("AAPL");
+    const auto quoted = table.intern("say \"hi\"\n");
+    const std::string long_name(40, 'x');
+    const auto big = table.intern(long_name);
+    EXPECT_EQ(table.json(quoted), "\"say \\\"hi\\\"\\n\"");
+
+    smallstring::Buffer<> buffer(1);
+    buffer.push_interned(table, plain);
+    buffer.push(",");
+    buffer.push_interned(table, quoted);
+    buffer.push(",");
+    buffer.push_interned(table, big);
+    EXPECT_EQ(buffer.view(), "\"AAPL\",\"say \\\"hi\\\"\\n\",\"" +
+                                 long_name + "\"");
+}
+
+TEST(smallstring_intern_test, read_mostly_concurrent_lookups) {
+    smallstring::InternTable<smallstring::InternReadMostly> table;
+    for (int i = 0; i < 1000; i++)
+        table.intern("V" + std::to_string(i));
+    table.publish();
+
+    std::vector<std::thread> threads;
+    std::vector<bool> ok(4, true);
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 4000; i++) {
+                const std::string name = "V" + std::to_string(i % 2000);
+                // Half the names are new; every thread must agree on ids.
+                const auto id = table.intern(name);
+                if (table.name(id) != name || table.find(name) != id)
+                    ok[t] = false;
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    EXPECT_EQ(table.size(), 2000u);
+    for (int t = 0; t < 4; t++)
+        EXPECT_TRUE(ok[t]);
+    for (int i = 0; i < 1000; i++)
+        EXPECT_EQ(table.find("V" + std::to_string(i)), std::uint32_t(i));
+}
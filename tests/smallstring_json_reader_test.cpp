@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <random>
+#include <smallstring/json_reader.hpp>
+#include <smallstring/smallstring.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Tokenizer = smallstring::JsonTokenizer;
+using Type = Tokenizer::TokenType;
+using Tokens = std::vector<std::pair<Type, std::string>>;
+
+Tokens collect(const Tokenizer& json) {
+    Tokens out;
+    for (const auto& token : json.tokens())
+        out.emplace_back(token.type, std::string(token.text));
+    return out;
+}
+
+/// Random JSON value (an object or array at depth 0); appends its expected
+/// tokens.
+void random_value(std::mt19937& rng, int depth, std::string& text,
+                  Tokens& tokens) {
+    const char* const spaces[] = {"", " ", "\n", "\t ", "\r\n  "};
+    const auto space = [&] { text += spaces[rng() % 5]; };
+    const auto string = [&] {
+        std::string body;
+        for (unsigned i = 0, n = rng() % 90; i < n; i++) {
+            switch (rng() % 8) {
+            case 0:
+                body += "\\\"";
+                break;
+            case 1:
+                body += std::string(2 + 2 * (rng() % 3), '\\');
+                break;
+            case 2:
+                body += "{[:,]}";
+                break;
+            default:
+                body += static_cast<char>('a' + rng() % 26);
+                break;
+            }
+        }
+        text += '"' + body + '"';
+        tokens.emplace_back(Type::string, body);
+    };
+    const unsigned kind = depth == 0   ? rng() % 2
+                          : depth >= 6 ? 2 + rng() % 5
+                                       : rng() % 7;
+    if (kind < 2) {
+        const bool object = kind == 0;
+        text += object ? '{' : '[';
+        tokens.emplace_back(object ? Type::object_begin : Type::array_begin,
+                            object ? "{" : "[");
+        for (unsigned i = 0, n = rng() % 6; i < n; i++) {
+            if (i) {
+                text += ',';
+                tokens.emplace_back(Type::comma, ",");
+            }
+            space();
+            if (object) {
+                string();
+                space();
+                text += ':';
+                tokens.emplace_back(Type::colon, ":");
+                space();
+            }
+            random_value(rng, depth + 1, text, tokens);
+            space();
+        }
+        text += object ? '}' : ']';
+        tokens.emplace_back(object ? Type::object_end : Type::array_end,
+                            object ? "}" : "]");
+    } else if (kind == 2) {
+        string();
+    } else if (kind == 3) {
+        const std::string number =
+            std::to_string(static_cast<long long>(rng()) - (1LL << 31)) +
+            (rng() % 2 ? ".5e-3" : "");
+        text += number;
+        tokens.emplace_back(Type::number, number);
+    } else {
+        const std::pair<Type, const char*> literals[] = {
+            {Type::true_value, "true"},
+            {Type::false_value, "false"},
+            {Type::null_value, "null"}};
+        const auto& literal = literals[kind - 4];
+        text += literal.second;
+        tokens.emplace_back(literal.first, literal.second);
+    }
+}
+
+} // namespace
+
+TEST(smallstring_json_reader_test, tokenizes_one_message) {
+    Tokenizer json;
+    const std::string text =
+        R"( {"sym":"A\"B","px":[1.5,-2e3],"ok":true,"x":null,"n":false})";
+    ASSERT_EQ(json.next(text), text.size());
+    EXPECT_EQ(json.message(), text.substr(1));
+    const Tokens expected = {
+        {Type::object_begin, "{"}, {Type::string, "sym"},
+        {Type::colon, ":"},        {Type::string, "A\\\"B"},
+        {Type::comma, ","},        {Type::string, "px"},
+        {Type::colon, ":"},        {Type::array_begin, "["},
+        {Type::number, "1.5"},     {Type::comma, ","},
+        {Type::number, "-2e3"},    {Type::array_end, "]"},
+        {Type::comma, ","},        {Type::string, "ok"},
+        {Type::colon, ":"},        {Type::true_value, "true"},
+        {Type::comma, ","},        {Type::string, "x"},
+        {Type::colon, ":"},        {Type::null_value, "null"},
+        {Type::comma, ","},        {Type::string, "n"},
+        {Type::colon, ":"},        {Type::false_value, "false"},
+        {Type::object_end, "}"}};
+    EXPECT_EQ(collect(json), expected);
+    for (const auto& token : json.tokens()) {
+        EXPECT_GE(token.text.data(), text.data());
+        EXPECT_LE(token.text.data() + token.text.size(),
+                  text.data() + text.size());
+    }
+}
+
+TEST(smallstring_json_reader_test, waits_for_a_complete_message) {
+    Tokenizer json;
+    std::string text = R"({"a":"})"; // the brace is inside the string
+    EXPECT_EQ(json.next(text), 0u);
+    text += R"(\"}")";
+    EXPECT_EQ(json.next(text), 0u);
+    text += "}";
+    ASSERT_EQ(json.next(text), text.size());
+    EXPECT_EQ(collect(json)[3], (Tokens::value_type{Type::string, "}\\\"}"}));
+    EXPECT_EQ(json.next(""), 0u);
+    EXPECT_FALSE(json.error());
+}
+
+TEST(smallstring_json_reader_test, frames_a_stream_fed_in_pieces) {
+    std::mt19937 rng(7);
+    std::string stream;
+    std::vector<Tokens> expected;
+    for (int i = 0; i < 300; i++) {
+        Tokens tokens;
+        random_value(rng, 0, stream, tokens);
+        stream += rng() % 2 ? "\n" : "";
+        expected.push_back(std::move(tokens));
+    }
+
+    for (const std::size_t chunk : {1, 7, 63, 64, 65, 500, 100000}) {
+        std::mt19937 sizes(static_cast<unsigned>(chunk));
+        Tokenizer json;
+        smallstring::Buffer<> inbound(16);
+        std::size_t fed = 0, seen = 0;
+        while (fed < stream.size()) {
+            const std::size_t n = std::min<std::size_t>(
+                1 + sizes() % chunk, stream.size() - fed);
+            inbound.push(std::string_view(stream).substr(fed, n));
+            fed += n;
+            while (const std::size_t used = json.next(inbound.view())) {
+                ASSERT_LT(seen, expected.size());
+                ASSERT_EQ(collect(json), expected[seen]) << "message " << seen;
+                inbound.pop(used);
+                seen++;
+            }
+        }
+        EXPECT_EQ(seen, expected.size()) << "chunk " << chunk;
+        EXPECT_FALSE(json.error());
+    }
+}
+
+TEST(smallstring_json_reader_test, junk_between_messages_is_an_error) {
+    Tokenizer json;
+    const std::string text = "[1] x [2]";
+    ASSERT_EQ(json.next(text), 3u);
+    EXPECT_EQ(json.next(std::string_view(text).substr(3)), 0u);
+    EXPECT_TRUE(json.error());
+    json.reset();
+    EXPECT_FALSE(json.error());
+    EXPECT_EQ(json.next("[2]"), 3u);
+}
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include <limits>
+#include <smallstring/json.hpp>
+
+struct smallstring_json_test_fixture : public ::testing::Test {
+    smallstring::Buffer<> buffer;
+    smallstring::JsonWriter<smallstring::Buffer<>> json{buffer};
+};
+
+TEST_F(smallstring_json_test_fixture, empty_object_and_array) {
+    json.begin_object();
+    json.end_object();
+    EXPECT_EQ(buffer.view(), "{}");
+    buffer.clear();
+    json.begin_array();
+    json.end_array();
+    EXPECT_EQ(buffer.view(), "[]");
+}
+
+TEST_F(smallstring_json_test_fixture, flat_object) {
+    json.begin_object();
+    json.key("id");
+    json.value(42);
+    json.key("px");
+    json.value_fixed(101.25, 4);
+    json.key("qty");
+    json.value(-7.5);
+    json.key("live");
+    json.value(true);
+    json.key("venue");
+    json.value(nullptr);
+    json.end_object();
+    EXPECT_EQ(buffer.view(), R"({"id":42,"px":101.2500,"qty":-7.5,)"
+                             R"("live":true,"venue":null})");
+    EXPECT_EQ(json.depth(), 0UL);
+}
+
+TEST_F(smallstring_json_test_fixture, nested_containers) {
+    json.begin_object();
+    json.key("bids");
+    json.begin_array();
+    for (int level = 0; level < 2; level++) {
+        json.begin_array();
+        json.value(100 - level);
+        json.value(10 * (level + 1));
+        json.end_array();
+    }
+    json.end_array();
+    json.key("meta");
+    json.begin_object();
+    json.key("seq");
+    json.value(7U);
+    json.end_object();
+    json.end_object();
+    EXPECT_EQ(buffer.view(),
+              R"({"bids":[[100,10],[99,20]],"meta":{"seq":7}})");
+}
+
+TEST_F(smallstring_json_test_fixture, strings_are_escaped) {
+    json.begin_array();
+    json.value("plain");
+    json.value(std::string("quote\" backslash\\"));
+    json.value(std::string_view("tab\tnewline\n\x01", 13));
+    json.end_array();
+    EXPECT_EQ(buffer.view(),
+              R"(["plain","quote\" backslash\\","tab\tnewline\n\u0001"])");
+}
+
+TEST_F(smallstring_json_test_fixture, non_finite_numbers_are_null) {
+    json.begin_array();
+    json.value(std::numeric_limits<double>::quiet_NaN());
+    json.value(std::numeric_limits<double>::infinity());
+    json.value(-std::numeric_limits<float>::infinity());
+    json.value_fixed(std::numeric_limits<double>::quiet_NaN(), 2);
+    json.value(0.5);
+    json.end_array();
+    EXPECT_EQ(buffer.view(), "[null,null,null,null,0.5]");
+}
+
+TEST_F(smallstring_json_test_fixture, runtime_keys_and_raw_values) {
+    std::string key = "sym\"bol";
+    json.begin_object();
+    json.key(std::string_view(key));
+    json.raw(R"({"cached":true})");
+    json.key("n");
+    json.value(1);
+    json.end_object();
+    EXPECT_EQ(buffer.view(), R"({"sym\"bol":{"cached":true},"n":1})");
+}
+
+TEST_F(smallstring_json_test_fixture, reset_between_messages) {
+    for (int i = 0; i < 2; i++) {
+        json.begin_object();
+        json.key("i");
+        json.value(i);
+        json.end_object();
+        buffer.push("\n");
+        json.reset();
+    }
+    EXPECT_EQ(buffer.view(), "{\"i\":0}\n{\"i\":1}\n");
+}
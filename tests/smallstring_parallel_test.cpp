@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <smallstring/parallel.hpp>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+void write_shard(std::size_t index, smallstring::Buffer<>& out) {
+    for (int line = 0; line < 100; line++) {
+        out.push(index);
+        out.push(':');
+        out.push(line);
+        out.push("\n");
+    }
+}
+
+std::string expected(std::size_t shards) {
+    smallstring::Buffer<> out;
+    for (std::size_t i = 0; i < shards; i++)
+        write_shard(i, out);
+    return std::string(out.view());
+}
+
+} // namespace
+
+TEST(smallstring_parallel_test, concatenates_shards_in_order) {
+    smallstring::ParallelBuilder<> builder(4, 64);
+    builder.build(37, write_shard);
+    EXPECT_EQ(builder.shards(), 37u);
+
+    smallstring::Buffer<> out;
+    out.push("head|");
+    builder.concatenate(out);
+    EXPECT_EQ(out.view(), "head|" + expected(37));
+    EXPECT_EQ(builder.length() + 5, out.length());
+}
+
+TEST(smallstring_parallel_test, large_output_uses_parallel_copy) {
+    smallstring::ParallelBuilder<> builder(3);
+    builder.build(16, [](std::size_t index, smallstring::Buffer<>& out) {
+        out.push(std::string(40000, static_cast<char>('a' + index)));
+    });
+    ASSERT_GE(builder.length(), builder.parallel_copy_min);
+
+    smallstring::Buffer<> out;
+    builder.concatenate(out);
+    ASSERT_EQ(out.length(), 16u * 40000);
+    for (std::size_t i = 0; i < 16; i++)
+        EXPECT_EQ(out.view()[i * 40000 + 39999], static_cast<char>('a' + i));
+}
+
+TEST(smallstring_parallel_test, builds_append_and_clear_reuses_buffers) {
+    smallstring::ParallelBuilder<> builder(2);
+    builder.build(3, write_shard);
+    builder.build(2, write_shard);
+    ASSERT_EQ(builder.shards(), 5u);
+    EXPECT_EQ(builder.shard(3).view(), builder.shard(0).view());
+
+    builder.clear();
+    EXPECT_EQ(builder.shards(), 0u);
+    builder.build(1, write_shard);
+    EXPECT_EQ(builder.shard(0).length(), expected(1).size());
+}
+
+TEST(smallstring_parallel_test, iovecs_skip_empty_shards) {
+    smallstring::ParallelBuilder<> builder(4);
+    builder.build(6, [](std::size_t index, smallstring::Buffer<>& out) {
+        if (index % 2 == 0)
+            out.push(index);
+    });
+    const auto iov = builder.iovecs();
+    ASSERT_EQ(iov.size(), 3u);
+    std::string joined;
+    for (const iovec& part : iov)
+        joined.append(static_cast<const char*>(part.iov_base), part.iov_len);
+    EXPECT_EQ(joined, "024");
+}
+
+TEST(smallstring_parallel_test, rethrows_shard_exceptions) {
+    smallstring::ParallelBuilder<> builder(4);
+    EXPECT_THROW(builder.build(8,
+                               [](std::size_t index, smallstring::Buffer<>&) {
+                                   if (index == 5)
+                                       throw std::runtime_error("shard");
+                               }),
+                 std::runtime_error);
+    // The pool is still usable afterwards.
+    builder.clear();
+    builder.build(4, write_shard);
+    smallstring::Buffer<> out;
+    builder.concatenate(out);
+    EXPECT_EQ(out.view(), expected(4));
+}
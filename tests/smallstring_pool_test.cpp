@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <smallstring/pool.hpp>
+#include <thread>
+#include <vector>
+
+TEST(smallstring_pool_test, returned_buffers_are_reused) {
+    smallstring::BufferPool<> pool(128);
+    const char* storage;
+    {
+        auto lease = pool.acquire();
+        EXPECT_EQ(lease->capacity(), 128UL);
+        lease->push("hello");
+        storage = lease->head();
+    }
+    auto lease = pool.acquire();
+    EXPECT_EQ(lease->head(), storage);
+    EXPECT_EQ(lease->length(), 0UL);
+
+    const auto stats = pool.stats();
+    EXPECT_EQ(stats.misses, 1UL);
+    EXPECT_EQ(stats.hits, 1UL);
+    EXPECT_EQ(stats.trims, 0UL);
+}
+
+TEST(smallstring_pool_test, oversized_buffers_are_trimmed) {
+    smallstring::BufferPool<> pool(64, 1024);
+    {
+        auto lease = pool.acquire();
+        lease->push(std::string(5000, 'x'));
+        EXPECT_GE(lease->capacity(), 5000UL);
+    }
+    EXPECT_EQ(pool.stats().trims, 1UL);
+    auto lease = pool.acquire();
+    EXPECT_EQ(lease->capacity(), 64UL);
+}
+
+TEST(smallstring_pool_test, leases_move_and_detach) {
+    smallstring::BufferPool<> pool;
+    auto first = pool.acquire();
+    first->push("kept");
+    auto second = std::move(first);
+    EXPECT_EQ(second->view(), "kept");
+
+    smallstring::Buffer<> owned = second.detach();
+    EXPECT_EQ(owned.view(), "kept");
+    second.reset();
+    pool.acquire();
+    EXPECT_EQ(pool.stats().misses, 2UL);
+}
+
+TEST(smallstring_pool_test, local_lists_spill_to_shared_overflow) {
+    smallstring::BufferPool<> pool(256, 64 * 1024, 2);
+    {
+        std::vector<smallstring::BufferPool<>::Lease> leases;
+        for (int i = 0; i < 5; i++)
+            leases.push_back(pool.acquire());
+    }
+    EXPECT_EQ(pool.stats().misses, 5UL);
+
+    // Three of the five went to the overflow list and are visible to other
+    // threads.
+    std::thread other([&] {
+        std::vector<smallstring::BufferPool<>::Lease> leases;
+        for (int i = 0; i < 4; i++)
+            leases.push_back(pool.acquire());
+    });
+    other.join();
+    EXPECT_EQ(pool.stats().hits, 3UL);
+    EXPECT_EQ(pool.stats().misses, 6UL);
+}
+
+TEST(smallstring_pool_test, concurrent_leases) {
+    smallstring::BufferPool<> pool;
+    pool.reserve(8);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 1000; i++) {
+                auto lease = pool.acquire();
+                lease->push(i);
+                ASSERT_EQ(lease->view(), std::to_string(i));
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    const auto stats = pool.stats();
+    EXPECT_EQ(stats.hits + stats.misses, 4000UL);
+    EXPECT_LE(stats.misses, 4UL);
+}
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <smallstring/queue.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(smallstring_queue_test, push_swaps_in_a_recycled_buffer) {
+    smallstring::SpscBufferQueue<> queue(2, 64);
+    EXPECT_EQ(queue.capacity(), 2UL);
+    EXPECT_EQ(queue.front(), nullptr);
+
+    smallstring::Buffer<> msg(16);
+    msg.push("first");
+    EXPECT_TRUE(queue.try_push(msg));
+    EXPECT_EQ(msg.length(), 0UL);
+    EXPECT_EQ(msg.capacity(), 64UL);
+
+    auto* ready = queue.front();
+    ASSERT_NE(ready, nullptr);
+    EXPECT_EQ(ready->view(), "first");
+    const char* storage = ready->head();
+    queue.pop();
+    EXPECT_EQ(queue.front(), nullptr);
+
+    // Going round the ring hands the drained storage back to the producer.
+    msg.push("second");
+    EXPECT_TRUE(queue.try_push(msg));
+    queue.pop();
+    msg.push("third");
+    EXPECT_TRUE(queue.try_push(msg));
+    EXPECT_EQ(msg.head(), storage);
+    EXPECT_EQ(msg.length(), 0UL);
+}
+
+TEST(smallstring_queue_test, try_push_fails_when_full) {
+    smallstring::SpscBufferQueue<> queue(1);
+    smallstring::Buffer<> msg;
+    msg.push("a");
+    EXPECT_TRUE(queue.try_push(msg));
+    msg.push("b");
+    EXPECT_FALSE(queue.try_push(msg));
+    EXPECT_EQ(msg.view(), "b");
+    queue.pop();
+    EXPECT_TRUE(queue.try_push(msg));
+    EXPECT_EQ(queue.front()->view(), "b");
+}
+
+TEST(smallstring_queue_test, spsc_threads_preserve_order) {
+    smallstring::SpscBufferQueue<> queue(8);
+    constexpr int messages = 20000;
+    std::thread producer([&] {
+        smallstring::Buffer<> msg;
+        for (int i = 0; i < messages; i++) {
+            msg.push(i);
+            queue.push(msg);
+        }
+    });
+    for (int expected = 0; expected < messages;) {
+        if (auto* ready = queue.front()) {
+            ASSERT_EQ(ready->view(), std::to_string(expected));
+            queue.pop();
+            expected++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+}
+
+TEST(smallstring_queue_test, mpsc_threads_deliver_everything) {
+    smallstring::MpscBufferQueue<> queue(16);
+    constexpr int producers = 4;
+    constexpr int messages = 5000;
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&, p] {
+            smallstring::Buffer<> msg;
+            for (int i = 0; i < messages; i++) {
+                msg.push(p);
+                msg.push(":");
+                msg.push(i);
+                queue.push(msg);
+            }
+        });
+    }
+
+    std::vector<int> next(producers, 0);
+    for (int received = 0; received < producers * messages;) {
+        if (auto* ready = queue.front()) {
+            const auto view = ready->view();
+            const int p = view[0] - '0';
+            ASSERT_EQ(view.substr(2), std::to_string(next[p]));
+            next[p]++;
+            queue.pop();
+            received++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    for (auto& thread : threads)
+        thread.join();
+    for (int p = 0; p < producers; p++)
+        EXPECT_EQ(next[p], messages);
+}
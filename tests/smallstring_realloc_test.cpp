@@ -0,0 +1,57 @@
+#include <cstring>
+#include <gtest/gtest.h>
+#include <smallstring/realloc.hpp>
+#include <string>
+#include <utility>
+
+namespace {
+
+std::string pattern(std::size_t n) {
+    std::string out(n, '\0');
+    for (std::size_t i = 0; i < n; i++)
+        out[i] = static_cast<char>('A' + i % 31);
+    return out;
+}
+
+} // namespace
+
+TEST(smallstring_realloc_test, reallocate_keeps_the_used_bytes) {
+    using Alloc = smallstring::ReallocAllocator<char, 4096>;
+    Alloc alloc;
+    const std::string bytes = pattern(1 << 20);
+    char* ptr = alloc.allocate(16);
+    std::memcpy(ptr, bytes.data(), 16);
+    // malloc -> malloc -> mapped -> mapped.
+    std::size_t old = 16;
+    for (const std::size_t size : {1000, 100000, 1 << 20}) {
+        ptr = alloc.reallocate(ptr, old, size, old);
+        ASSERT_EQ(std::string(ptr, old), bytes.substr(0, old));
+        std::memcpy(ptr, bytes.data(), size);
+        old = size;
+    }
+    EXPECT_EQ(std::string(ptr, bytes.size()), bytes);
+    alloc.deallocate(ptr, 1 << 20);
+}
+
+TEST(smallstring_realloc_test, buffer_grows_without_losing_contents) {
+    smallstring::ReallocBuffer<> buffer(8);
+    const std::string bytes = pattern(3 << 20);
+    for (std::size_t at = 0; at < bytes.size(); at += 777)
+        buffer.push(std::string_view(bytes).substr(at, 777));
+    EXPECT_EQ(buffer.view(), bytes);
+
+    buffer.pop(1000);
+    buffer.push("!");
+    EXPECT_EQ(buffer.view(), bytes.substr(1000) + "!");
+
+    smallstring::ReallocBuffer<> copy(buffer);
+    EXPECT_EQ(copy.view(), buffer.view());
+    smallstring::ReallocBuffer<> moved(std::move(copy));
+    EXPECT_EQ(moved.view(), buffer.view());
+    copy = std::move(moved);
+    EXPECT_EQ(copy.view(), buffer.view());
+
+    buffer.drop_memory();
+    buffer.push(42);
+    EXPECT_EQ(buffer.view(), "42");
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <smallstring/ring_buffer.hpp>
+#include <string>
+#include <thread>
+
+TEST(smallstring_ring_buffer_test, capacity_is_rounded_to_pages) {
+    smallstring::RingBuffer ring(100);
+    EXPECT_GE(ring.capacity(), 100UL);
+    EXPECT_EQ(ring.capacity() & (ring.capacity() - 1), 0UL);
+    EXPECT_EQ(ring.space(), ring.capacity());
+    EXPECT_EQ(ring.view(), "");
+}
+
+TEST(smallstring_ring_buffer_test, pushes_are_visible_after_publish) {
+    smallstring::RingBuffer ring;
+    ring.push("{\"seq\":");
+    ring.push(17);
+    EXPECT_EQ(ring.view(), "");
+    ring.push("}");
+    ring.publish();
+    EXPECT_EQ(ring.view(), "{\"seq\":17}");
+    ring.push("unfinished");
+    ring.discard();
+    ring.pop(1);
+    EXPECT_EQ(ring.view(), "\"seq\":17}");
+    EXPECT_EQ(ring.find("17"), 6UL);
+}
+
+TEST(smallstring_ring_buffer_test, view_stays_contiguous_across_the_wrap) {
+    smallstring::RingBuffer ring(1);
+    const std::size_t capacity = ring.capacity();
+    std::string filler(capacity - 3, 'x');
+    ring.push(filler);
+    ring.publish();
+    ring.pop(filler.size());
+
+    // This message straddles the end of the ring.
+    ring.push("wrapped message");
+    ring.publish();
+    EXPECT_EQ(ring.view(), "wrapped message");
+    EXPECT_EQ(ring.space(), capacity - 15);
+}
+
+TEST(smallstring_ring_buffer_test, oversized_push_throws) {
+    smallstring::RingBuffer ring(1);
+    std::string too_big(ring.capacity() + 1, 'x');
+    EXPECT_THROW(ring.push(too_big), std::length_error);
+}
+
+TEST(smallstring_ring_buffer_test, unpublished_overflow_throws) {
+    smallstring::RingBuffer ring(1);
+    const std::string half(ring.capacity() / 2 + 100, 'x');
+    ring.push(half);
+    EXPECT_THROW(ring.push(half), std::length_error);
+    ring.publish();
+    ring.pop(half.size());
+    ring.push(half);
+    EXPECT_EQ(ring.length(), 0u);
+}
+
+TEST(smallstring_ring_buffer_test, producer_and_consumer_threads) {
+    smallstring::RingBuffer ring(1);
+    constexpr int messages = 20000;
+    std::thread producer([&] {
+        for (int i = 0; i < messages; i++) {
+            ring.push(i);
+            ring.push("\n");
+            ring.publish();
+        }
+    });
+
+    int expected = 0;
+    std::string line;
+    while (expected < messages) {
+        const auto pending = ring.view();
+        const auto newline = pending.find('\n');
+        if (newline == std::string_view::npos)
+            continue;
+        ASSERT_EQ(pending.substr(0, newline), std::to_string(expected));
+        ring.pop(newline + 1);
+        expected++;
+    }
+    producer.join();
+    EXPECT_EQ(ring.length(), 0UL);
+}
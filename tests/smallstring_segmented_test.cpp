@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include <smallstring/segmented.hpp>
+#include <string>
+#include <unistd.h>
+
+TEST(smallstring_segmented_test, small_pushes_are_coalesced) {
+    smallstring::SegmentedBuffer<> buf(64);
+    buf.push("{\"seq\":");
+    buf.push(42);
+    buf.push(std::string_view("}"));
+    EXPECT_EQ(buf.borrowed_length(), 0UL);
+    EXPECT_EQ(buf.iovecs().size(), 1UL);
+    EXPECT_EQ(buf.view(), "{\"seq\":42}");
+}
+
+TEST(smallstring_segmented_test, large_pushes_are_borrowed) {
+    const std::string snapshot(100, 's');
+    const std::string tail(80, 't');
+    smallstring::SegmentedBuffer<> buf(64);
+    buf.push("{\"snapshot\":");
+    buf.push(snapshot);
+    buf.push(std::string_view(tail));
+    buf.push("}");
+
+    EXPECT_EQ(buf.borrowed_length(), 180UL);
+    EXPECT_EQ(buf.owned_length(), 13UL);
+    const auto& iov = buf.iovecs();
+    ASSERT_EQ(iov.size(), 4UL);
+    EXPECT_EQ(iov[1].iov_base, static_cast<const void*>(snapshot.data()));
+    EXPECT_EQ(iov[2].iov_base, static_cast<const void*>(tail.data()));
+    EXPECT_EQ(iov[3].iov_len, 1UL);
+    EXPECT_EQ(buf.view(), "{\"snapshot\":" + snapshot + tail + "}");
+
+    // Temporaries cannot be borrowed.
+    buf.clear();
+    buf.push(std::string(100, 'x'));
+    EXPECT_EQ(buf.borrowed_length(), 0UL);
+    EXPECT_EQ(buf.view(), std::string(100, 'x'));
+}
+
+TEST(smallstring_segmented_test, iovecs_feed_writev) {
+    const std::string payload(5000, 'p');
+    smallstring::SegmentedBuffer<> buf;
+    buf.push("[");
+    buf.push(payload);
+    buf.push(",");
+    buf.push(7);
+    buf.push("]");
+
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    const auto& iov = buf.iovecs();
+    const ssize_t written =
+        writev(fds[1], iov.data(), static_cast<int>(iov.size()));
+    close(fds[1]);
+    ASSERT_EQ(written, static_cast<ssize_t>(buf.length()));
+
+    std::string received(buf.length(), '\0');
+    std::size_t got = 0;
+    while (got < received.size()) {
+        const ssize_t n = read(fds[0], &received[got], received.size() - got);
+        ASSERT_GT(n, 0);
+        got += static_cast<std::size_t>(n);
+    }
+    close(fds[0]);
+    EXPECT_EQ(received, "[" + payload + ",7]");
+}
@@ -1,5 +1,10 @@
+#include <cstdlib>
 #include <gtest/gtest.h>
+#include <limits>
 #include <smallstring/smallstring.hpp>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
 
 struct smallstring_simple_test_fixture : public ::testing::Test {
     smallstring::Buffer<> buffer;
@@ -81,4 +86,538 @@ TEST_F(smallstring_simple_test_fixture, mixed_push_and_pop) {
     EXPECT_EQ(buffer.view(), "testsymbol|");
     buffer.clear();
     EXPECT_EQ(buffer.view(), "");
-}
\ No newline at end of file
+}
+TEST(smallstring_growth_test, doubling_growth_is_geometric) {
+    smallstring::Buffer<> buffer(4);
+    buffer.push("abcde");
+    EXPECT_EQ(buffer.capacity(), 8UL);
+    buffer.push("fghi");
+    EXPECT_EQ(buffer.capacity(), 16UL);
+    buffer.push("this is much longer than sixteen");
+    EXPECT_EQ(buffer.capacity(), 41UL);
+    EXPECT_EQ(buffer.view(), "abcdefghithis is much longer than sixteen");
+}
+
+TEST(smallstring_growth_test, exact_growth_fits_request) {
+    smallstring::Buffer<std::allocator<char>, smallstring::ExactGrowth> buffer(
+        4);
+    buffer.push("abcde");
+    EXPECT_EQ(buffer.capacity(), 5UL);
+    buffer.push("f");
+    EXPECT_EQ(buffer.capacity(), 6UL);
+    EXPECT_EQ(buffer.view(), "abcdef");
+}
+
+struct add_sixty_four_growth {
+    static std::size_t grow(std::size_t, std::size_t required) {
+        return required + 64;
+    }
+};
+
+TEST(smallstring_growth_test, custom_growth_policy) {
+    smallstring::Buffer<std::allocator<char>, add_sixty_four_growth> buffer(0);
+    buffer.push("abc");
+    EXPECT_EQ(buffer.capacity(), 67UL);
+    EXPECT_EQ(buffer.view(), "abc");
+}
+
+TEST(smallstring_growth_test, grows_after_drop_memory) {
+    smallstring::Buffer<> buffer;
+    buffer.push("abc");
+    buffer.drop_memory();
+    EXPECT_EQ(buffer.capacity(), 0UL);
+    buffer.push("defg");
+    EXPECT_EQ(buffer.view(), "defg");
+}
+
+struct counting_allocator {
+    using value_type = char;
+    static inline std::size_t allocations = 0;
+
+    counting_allocator() = default;
+    template <class U> counting_allocator(const U&) {}
+
+    char* allocate(std::size_t n) {
+        ++allocations;
+        return std::allocator<char>().allocate(n);
+    }
+    void deallocate(char* ptr, std::size_t n) {
+        std::allocator<char>().deallocate(ptr, n);
+    }
+    bool operator==(const counting_allocator&) const { return true; }
+    bool operator!=(const counting_allocator&) const { return false; }
+};
+
+TEST(smallstring_inline_test, small_messages_do_not_allocate) {
+    counting_allocator::allocations = 0;
+    smallstring::InlineBuffer<32, counting_allocator> buffer;
+    EXPECT_EQ(buffer.capacity(), 32UL);
+    buffer.push("{\"id\":");
+    buffer.push(42);
+    buffer.push("}");
+    EXPECT_EQ(buffer.view(), "{\"id\":42}");
+    EXPECT_EQ(counting_allocator::allocations, 0UL);
+}
+
+TEST(smallstring_inline_test, spills_to_allocator) {
+    counting_allocator::allocations = 0;
+    smallstring::InlineBuffer<8, counting_allocator> buffer;
+    buffer.push("0123456");
+    buffer.push("789abcdef");
+    EXPECT_EQ(buffer.view(), "0123456789abcdef");
+    EXPECT_EQ(buffer.capacity(), 16UL);
+    EXPECT_EQ(counting_allocator::allocations, 1UL);
+    buffer.pop(10);
+    EXPECT_EQ(buffer.view(), "abcdef");
+    EXPECT_EQ(buffer.find("cd"), 2UL);
+
+    buffer.drop_memory();
+    EXPECT_EQ(buffer.capacity(), 8UL);
+    buffer.push("again");
+    EXPECT_EQ(buffer.view(), "again");
+}
+
+TEST(smallstring_inline_test, copy_and_move) {
+    smallstring::InlineBuffer<8> small;
+    small.push("abc");
+    smallstring::InlineBuffer<8> big;
+    big.push("a much longer string");
+
+    auto small_copy = small;
+    auto big_copy = big;
+    EXPECT_EQ(small_copy.view(), "abc");
+    EXPECT_EQ(big_copy.view(), "a much longer string");
+    EXPECT_NE(big_copy.head(), big.head());
+
+    const char* big_head = big.head();
+    auto small_moved = std::move(small);
+    auto big_moved = std::move(big);
+    EXPECT_EQ(small_moved.view(), "abc");
+    EXPECT_EQ(big_moved.view(), "a much longer string");
+    EXPECT_EQ(big_moved.head(), big_head);
+
+    small_moved = big_copy;
+    EXPECT_EQ(small_moved.view(), "a much longer string");
+    big_moved = std::move(small_copy);
+    EXPECT_EQ(big_moved.view(), "abc");
+}
+
+TEST(smallstring_inline_test, moves_keep_unconsumed_bytes) {
+    smallstring::InlineBuffer<32> buffer;
+    buffer.push("popped|live");
+    buffer.pop(7);
+    auto moved = std::move(buffer);
+    EXPECT_EQ(moved.view(), "live");
+    EXPECT_EQ(buffer.length(), 0UL);
+
+    smallstring::InlineBuffer<32> assigned;
+    assigned.push("old contents");
+    assigned = std::move(moved);
+    EXPECT_EQ(assigned.view(), "live");
+    assigned.push("+more");
+    EXPECT_EQ(assigned.view(), "live+more");
+
+    using Inline = smallstring::InlineBuffer<32>;
+    static_assert(std::is_nothrow_move_constructible<Inline>::value);
+    static_assert(std::is_nothrow_move_assignable<Inline>::value);
+    static_assert(
+        std::is_nothrow_move_assignable<smallstring::Buffer<>>::value);
+}
+
+TEST(smallstring_inline_test, copies_only_unconsumed_bytes) {
+    counting_allocator::allocations = 0;
+    smallstring::InlineBuffer<8, counting_allocator> buffer;
+    buffer.push("a much longer string");
+    buffer.pop(14);
+    EXPECT_EQ(counting_allocator::allocations, 1UL);
+
+    // The six live bytes fit inline: no allocation, no popped bytes.
+    auto copy = buffer;
+    EXPECT_EQ(copy.view(), "string");
+    EXPECT_EQ(copy.capacity(), 8UL);
+    EXPECT_EQ(counting_allocator::allocations, 1UL);
+
+    smallstring::InlineBuffer<8, counting_allocator> assigned;
+    assigned = buffer;
+    EXPECT_EQ(assigned.view(), "string");
+    EXPECT_EQ(assigned.capacity(), 8UL);
+    EXPECT_EQ(counting_allocator::allocations, 1UL);
+
+    smallstring::Buffer<> heap;
+    heap.push("xxxxhello");
+    heap.pop(4);
+    smallstring::Buffer<> heap_copy(heap);
+    EXPECT_EQ(heap_copy.view(), "hello");
+    EXPECT_EQ(heap_copy.capacity(), heap.capacity());
+}
+
+TEST_F(smallstring_simple_test_fixture, append_zero) {
+    buffer.push(0);
+    buffer.push(0UL);
+    EXPECT_EQ(buffer.view(), "00");
+    EXPECT_EQ(buffer.length(), 2UL);
+}
+
+TEST_F(smallstring_simple_test_fixture, append_integer_limits) {
+    buffer.push(std::numeric_limits<int64_t>::min());
+    buffer.push("|");
+    buffer.push(std::numeric_limits<int32_t>::min());
+    buffer.push("|");
+    buffer.push(std::numeric_limits<uint64_t>::max());
+    buffer.push("|");
+    buffer.push(std::numeric_limits<int8_t>::min());
+    EXPECT_EQ(buffer.view(), "-9223372036854775808|-2147483648|"
+                             "18446744073709551615|-128");
+}
+
+TEST_F(smallstring_simple_test_fixture, append_integer_digit_boundaries) {
+    uint64_t power = 1;
+    for (int digits = 1; digits <= 20; digits++) {
+        for (uint64_t value : {power - 1, power, power + 1}) {
+            buffer.clear();
+            buffer.push(value);
+            EXPECT_EQ(buffer.view(), std::to_string(value));
+            buffer.clear();
+            buffer.push(-static_cast<int64_t>(value / 2));
+            EXPECT_EQ(buffer.view(),
+                      std::to_string(-static_cast<int64_t>(value / 2)));
+        }
+        power *= 10;
+    }
+}
+
+TEST_F(smallstring_simple_test_fixture, append_double_shortest) {
+    buffer.push(0.1);
+    buffer.push("|");
+    buffer.push(-2.5);
+    buffer.push("|");
+    buffer.push(1e22);
+    buffer.push("|");
+    buffer.push(123456.0);
+    buffer.push("|");
+    buffer.push(5e-324);
+    buffer.push("|");
+    buffer.push(-0.0);
+    EXPECT_EQ(buffer.view(), "0.1|-2.5|1e+22|123456|5e-324|-0");
+}
+
+TEST_F(smallstring_simple_test_fixture, append_float_shortest) {
+    buffer.push(0.1f);
+    buffer.push("|");
+    buffer.push(3.4028235e38f);
+    buffer.push("|");
+    buffer.push(1.0f / 3.0f);
+    EXPECT_EQ(buffer.view(), "0.1|3.4028235e+38|0.33333334");
+}
+
+TEST_F(smallstring_simple_test_fixture, append_large_integers_exactly) {
+    // Fixed notation prints the binary value, not padded shortest digits.
+    buffer.push(190944592.f);
+    buffer.push("|");
+    buffer.push(9223372036854775808.0);
+    buffer.push("|");
+    buffer.push(1180591620717411303424.0); // 2^70
+    buffer.push("|");
+    buffer.push(1e21);
+    EXPECT_EQ(buffer.view(),
+              "190944592|9223372036854775808|1180591620717411303424|1e+21");
+}
+
+TEST_F(smallstring_simple_test_fixture, append_double_non_finite) {
+    buffer.push(std::numeric_limits<double>::infinity());
+    buffer.push("|");
+    buffer.push(-std::numeric_limits<double>::infinity());
+    buffer.push("|");
+    buffer.push(std::numeric_limits<double>::quiet_NaN());
+    EXPECT_EQ(buffer.view(), "inf|-inf|nan");
+}
+
+TEST_F(smallstring_simple_test_fixture, append_double_round_trips) {
+    for (double value : {1.0 / 3.0, 2.2250738585072014e-308,
+                         1.7976931348623157e308, 9007199254740993.0,
+                         0.30000000000000004, 12345.678901}) {
+        buffer.clear();
+        buffer.push(value);
+        EXPECT_EQ(std::strtod(std::string(buffer.view()).c_str(), nullptr),
+                  value);
+    }
+}
+
+TEST_F(smallstring_simple_test_fixture, append_fixed_precision) {
+    buffer.push_fixed(101.25, 4);
+    buffer.push("|");
+    buffer.push_fixed(-0.00042, 2);
+    buffer.push("|");
+    buffer.push_fixed(9.995, 2);
+    buffer.push("|");
+    buffer.push_fixed(1.005, 2);
+    buffer.push("|");
+    buffer.push_fixed(2.5, 0);
+    buffer.push("|");
+    buffer.push_fixed(1e20, 1);
+    EXPECT_EQ(buffer.view(),
+              "101.2500|-0.00|10.00|1.01|3|100000000000000000000.0");
+}
+
+TEST_F(smallstring_simple_test_fixture, append_escaped) {
+    buffer.push_escaped("plain text");
+    EXPECT_EQ(buffer.view(), "plain text");
+    buffer.clear();
+    buffer.push_escaped(std::string_view("\"q\" \\ \b\f\n\r\t\x1f\0", 13));
+    EXPECT_EQ(buffer.view(), "\\\"q\\\" \\\\ \\b\\f\\n\\r\\t\\u001f\\u0000");
+    buffer.clear();
+    buffer.push_escaped("caf\xc3\xa9 \x7f");
+    EXPECT_EQ(buffer.view(), "caf\xc3\xa9 \x7f");
+}
+
+TEST_F(smallstring_simple_test_fixture, append_escaped_long_runs) {
+    // Escapes at every offset of a string longer than one SIMD block, so
+    // each of the vector, remainder and growth paths is exercised.
+    for (std::size_t at = 0; at < 70; at++) {
+        std::string input(70, 'x');
+        input[at] = '"';
+        std::string expected = input.substr(0, at) + "\\\"" +
+                               input.substr(at + 1);
+        smallstring::Buffer<> small(1);
+        small.push_escaped(input);
+        EXPECT_EQ(small.view(), expected);
+        EXPECT_EQ(smallstring::detail::find_json_escape(input.data(),
+                                                        input.size()),
+                  smallstring::detail::find_json_escape_scalar(
+                      input.data(), input.size()));
+    }
+}
+
+TEST(smallstring_pop_test, pop_moves_the_front_without_copying) {
+    smallstring::Buffer<> buffer(16);
+    buffer.push("header|body");
+    const char* body = buffer.head() + 7;
+    buffer.pop(7);
+    EXPECT_EQ(buffer.head(), body);
+    EXPECT_EQ(buffer.view(), "body");
+    EXPECT_EQ(buffer.find("dy"), 2UL);
+    EXPECT_EQ(buffer.remaining(), 12UL);
+}
+
+TEST(smallstring_pop_test, consumed_space_is_reclaimed_before_growing) {
+    smallstring::Buffer<> buffer(16);
+    buffer.push("0123456789abcdef");
+    buffer.pop(10);
+    buffer.push("ghijklmnop");
+    EXPECT_EQ(buffer.capacity(), 16UL);
+    EXPECT_EQ(buffer.view(), "abcdefghijklmnop");
+    buffer.pop(4);
+    buffer.push("0123456789");
+    EXPECT_EQ(buffer.capacity(), 32UL);
+    EXPECT_EQ(buffer.view(), "efghijklmnop0123456789");
+}
+
+TEST(smallstring_pop_test, framed_consume_loop) {
+    smallstring::Buffer<> buffer(8);
+    std::string consumed;
+    for (int i = 0; i < 100; i++) {
+        buffer.push("msg");
+        buffer.push(i);
+        buffer.push("\n");
+        const auto newline = buffer.find("\n");
+        consumed.append(buffer.view().substr(0, newline));
+        buffer.pop(newline + 1);
+    }
+    EXPECT_EQ(buffer.length(), 0UL);
+    EXPECT_EQ(consumed.substr(0, 12), "msg0msg1msg2");
+    EXPECT_LE(buffer.capacity(), 8UL);
+}
+
+TEST(smallstring_move_test, moved_from_buffer_is_empty_and_usable) {
+    smallstring::Buffer<> source;
+    source.push("payload");
+    smallstring::Buffer<> target(std::move(source));
+    EXPECT_EQ(target.view(), "payload");
+    EXPECT_EQ(source.length(), 0UL);
+    source.push("reused");
+    EXPECT_EQ(source.view(), "reused");
+
+    target = std::move(source);
+    EXPECT_EQ(target.view(), "reused");
+    EXPECT_EQ(source.view(), "");
+}
+
+TEST(smallstring_writer_test, unchecked_pushes_commit_on_destruction) {
+    smallstring::Buffer<> buffer(4);
+    buffer.push("<");
+    {
+        auto w = buffer.reserve_writer(64);
+        EXPECT_GE(buffer.capacity(), 65UL);
+        w.push_unchecked("id=");
+        w.push_unchecked(-12345);
+        w.push_char_unchecked(' ');
+        w.push_unchecked(std::string_view("px="));
+        w.push_unchecked(static_cast<std::uint64_t>(18446744073709551615ULL));
+        EXPECT_EQ(w.written(), 33UL);
+        EXPECT_EQ(buffer.length(), 1UL);
+    }
+    buffer.push(">");
+    EXPECT_EQ(buffer.view(), "<id=-12345 px=18446744073709551615>");
+}
+
+TEST(smallstring_find_test, matches_string_view_find) {
+    std::string text;
+    for (int i = 0; i < 200; i++)
+        text += "field" + std::to_string(i) + (i % 7 ? "," : "}\r\n");
+    smallstring::Buffer<> buffer;
+    buffer.push(text);
+    const std::string_view view(text);
+
+    for (const char* needle : {"}\r\n", "\r\n", "}", "field199", "xyz", "",
+                               "field17,field18,"}) {
+        for (std::size_t pos : {0UL, 1UL, 37UL, 500UL, text.size()}) {
+            EXPECT_EQ(buffer.find(needle, pos), view.find(needle, pos))
+                << needle << " @" << pos;
+        }
+    }
+    EXPECT_EQ(buffer.find("", text.size() + 1), std::string_view::npos);
+
+    for (std::size_t pos = 0; pos < text.size(); pos += 13) {
+        EXPECT_EQ(buffer.find_byte('\n', pos), view.find('\n', pos));
+        EXPECT_EQ(buffer.find_any_of("}\r", pos),
+                  view.find_first_of("}\r", pos));
+    }
+    EXPECT_EQ(buffer.find_byte('#'), std::string_view::npos);
+}
+
+TEST(smallstring_find_test, byte_sets) {
+    smallstring::Buffer<> buffer;
+    buffer.push(std::string(100, 'a'));
+    buffer.push("\x80z");
+
+    const smallstring::ByteSet high("\x80\xff");
+    EXPECT_EQ(buffer.find_any_of(high), 100UL);
+    // Larger than the vectorised limit: table lookup.
+    EXPECT_EQ(buffer.find_any_of("0123456789z"), 101UL);
+    EXPECT_EQ(buffer.find_any_of(""), std::string_view::npos);
+    EXPECT_EQ(buffer.find_any_of("bc", 50), std::string_view::npos);
+}
+
+TEST(smallstring_encoding_test, hex) {
+    smallstring::Buffer<> buffer(4);
+    buffer.push_hex(std::string_view("\x00\x7f\x80\xff", 4));
+    buffer.push(" ");
+    buffer.push_hex(std::uint32_t(0xdeadbeef));
+    buffer.push(" ");
+    buffer.push_hex(std::int16_t(-2));
+    EXPECT_EQ(buffer.view(), "007f80ff deadbeef fffe");
+
+    std::string bytes;
+    std::string expected;
+    for (int i = 0; i < 100; i++) {
+        bytes += static_cast<char>(i * 37);
+        const char* digits = "0123456789abcdef";
+        expected += digits[(i * 37 & 0xff) >> 4];
+        expected += digits[i * 37 & 0x0f];
+    }
+    buffer.clear();
+    buffer.push_hex(bytes);
+    EXPECT_EQ(buffer.view(), expected);
+}
+
+TEST(smallstring_encoding_test, base64) {
+    const std::pair<std::string_view, std::string_view> vectors[] = {
+        {"", ""},         {"f", "Zg=="},         {"fo", "Zm8="},
+        {"foo", "Zm9v"},  {"foob", "Zm9vYg=="},  {"fooba", "Zm9vYmE="},
+        {"foobar", "Zm9vYmFy"},
+        {"The quick brown fox jumps over the lazy dog",
+         "VGhlIHF1aWNrIGJyb3duIGZveCBqdW1wcyBvdmVyIHRoZSBsYXp5IGRvZw=="},
+    };
+    for (const auto& [input, encoded] : vectors) {
+        smallstring::Buffer<> buffer(1);
+        buffer.push_base64(input);
+        EXPECT_EQ(buffer.view(), encoded);
+    }
+
+    // Every 6-bit value, through the vectorised path.
+    std::string bytes;
+    for (int i = 0; i < 64; i++)
+        bytes += static_cast<char>(i << 2);
+    bytes += std::string_view("\xff\xff\xff", 3);
+    smallstring::Buffer<> buffer;
+    buffer.push_base64(bytes);
+    EXPECT_EQ(buffer.view(), "AAQIDBAUGBwgJCgsMDQ4PEBESExQVFhcYGRobHB0eHyAhIiMk"
+                             "JSYnKCkqKywtLi8wMTIzNDU2Nzg5Ojs8PT4/P///w==");
+}
+
+TEST(smallstring_encoding_test, padded) {
+    smallstring::Buffer<> buffer;
+    buffer.push_padded(42, 6);
+    buffer.push("|");
+    buffer.push_padded(-42, 6);
+    buffer.push("|");
+    buffer.push_padded(-42, 6, ' ');
+    buffer.push("|");
+    buffer.push_padded(123456789u, 4);
+    buffer.push("|");
+    buffer.push_padded(0, 0);
+    EXPECT_EQ(buffer.view(), "000042|-00042|   -42|123456789|0");
+}
+
+TEST(smallstring_frame_test, big_endian_header_with_growth) {
+    smallstring::Buffer<> buffer(4);
+    buffer.push("x");
+    auto frame = buffer.begin_frame<std::uint32_t>();
+    const std::string body(300, 'b');
+    buffer.push(body);
+    EXPECT_EQ(frame.length(), 300u);
+    frame.end();
+    EXPECT_EQ(buffer.view(), std::string("x\x00\x00\x01\x2c", 5) + body);
+}
+
+TEST(smallstring_frame_test, nested_varint_and_ascii_frames) {
+    smallstring::Buffer<> buffer;
+    {
+        auto outer =
+            buffer.begin_frame<std::uint64_t, smallstring::FrameVarint>();
+        buffer.push("<");
+        {
+            auto inner = buffer.begin_frame<std::uint16_t,
+                                            smallstring::FrameAscii>();
+            buffer.push("hello");
+        } // ended on destruction
+        buffer.push(">");
+        outer.end();
+    }
+    EXPECT_EQ(buffer.view(), "\x08<5hello>");
+
+    buffer.clear();
+    auto frame =
+        buffer.begin_frame<std::uint32_t, smallstring::FrameVarint>();
+    buffer.push(std::string(200, 'v'));
+    frame.end();
+    EXPECT_EQ(buffer.view().substr(0, 2), "\xc8\x01");
+    EXPECT_EQ(buffer.length(), 202u);
+}
+
+TEST(smallstring_frame_test, little_endian_and_overflow) {
+    smallstring::Buffer<> buffer;
+    auto small = buffer.begin_frame<std::uint8_t>();
+    buffer.push(std::string(256, 'o'));
+    EXPECT_THROW(small.end(), std::length_error);
+    buffer.truncate(1 + 255);
+    small.end();
+    EXPECT_EQ(buffer.view()[0], '\xff');
+
+    buffer.clear();
+    auto frame = buffer.begin_frame<std::uint16_t,
+                                    smallstring::FrameLittleEndian>();
+    buffer.push("abc");
+    frame.end();
+    EXPECT_EQ(buffer.view(), std::string("\x03\x00" "abc", 5));
+}
+
+TEST(smallstring_frame_test, oversized_frame_is_dropped_on_destruction) {
+    smallstring::Buffer<> buffer;
+    buffer.push("kept");
+    {
+        auto frame = buffer.begin_frame<std::uint8_t>();
+        buffer.push(std::string(256, 'o'));
+    }
+    EXPECT_EQ(buffer.view(), "kept");
+}
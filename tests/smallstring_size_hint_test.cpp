@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include <smallstring/size_hint.hpp>
+#include <string>
+
+TEST(smallstring_size_hint_test, tracks_the_high_quantile) {
+    smallstring::SizeHint hint;
+    EXPECT_EQ(hint.capacity(), 256UL);
+
+    // Heartbeats: tiny messages shrink the hint to the minimum.
+    for (int i = 0; i < 256; i++)
+        hint.record(12);
+    EXPECT_EQ(hint.capacity(), 16UL);
+
+    // Snapshots: once more than 1% are ~3 KiB, p99 covers them.
+    for (int i = 0; i < 256; i++)
+        hint.record(i % 10 == 0 ? 3000 : 12);
+    EXPECT_EQ(hint.capacity(), 4096UL);
+}
+
+TEST(smallstring_size_hint_test, adapts_after_traffic_shifts) {
+    smallstring::SizeHint hint(256, 0.99, 16, 1 << 16);
+    for (int i = 0; i < 8192; i++)
+        hint.record(1 << 20); // clamped to the maximum
+    EXPECT_EQ(hint.capacity(), 1UL << 16);
+    for (int i = 0; i < 32768; i++)
+        hint.record(100);
+    EXPECT_EQ(hint.capacity(), 128UL);
+}
+
+TEST(smallstring_size_hint_test, buffers_report_on_completion) {
+    smallstring::SizeHint hint;
+    for (int i = 0; i < 64; i++) {
+        auto buffer = hint.make_buffer();
+        buffer.push(std::string(1000, 'x'));
+    }
+    EXPECT_EQ(hint.capacity(), 1024UL);
+
+    auto buffer = hint.make_buffer();
+    EXPECT_EQ(buffer.capacity(), 1024UL);
+    EXPECT_EQ(buffer.stats().hint(), &hint);
+}
+
+TEST(smallstring_size_hint_test, clear_shrinks_to_the_hint) {
+    smallstring::Buffer<> buffer(16);
+    buffer.push(std::string(100000, 'x'));
+    buffer.clear(256);
+    EXPECT_EQ(buffer.length(), 0UL);
+    EXPECT_EQ(buffer.capacity(), 256UL);
+
+    buffer.push("small");
+    buffer.clear(1024); // already below: kept
+    EXPECT_EQ(buffer.capacity(), 256UL);
+}
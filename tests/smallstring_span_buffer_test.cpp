@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <smallstring/json.hpp>
+#include <smallstring/span_buffer.hpp>
+#include <string>
+#include <vector>
+
+TEST(smallstring_span_buffer_test, formats_into_external_memory) {
+    char storage[64];
+    smallstring::SpanBuffer out(storage, sizeof(storage));
+    out.push("px=");
+    out.push_fixed(101.25, 2);
+    out.push(" qty=");
+    out.push(300);
+    EXPECT_EQ(out.view(), "px=101.25 qty=300");
+    EXPECT_EQ(out.head(), storage);
+    EXPECT_FALSE(out.overflowed());
+}
+
+TEST(smallstring_span_buffer_test, drop_policy_keeps_whole_pushes_only) {
+    char storage[8];
+    smallstring::SpanBuffer out(storage, sizeof(storage));
+    out.push("hello");
+    out.push("world");
+    out.push(123456789);
+    out.push(1.5);
+    EXPECT_EQ(out.view(), "hello1.5");
+    EXPECT_TRUE(out.overflowed());
+
+    out.clear();
+    EXPECT_FALSE(out.overflowed());
+    EXPECT_EQ(out.length(), 0UL);
+}
+
+TEST(smallstring_span_buffer_test, drop_policy_keeps_whole_escaped_pushes) {
+    char storage[8];
+    smallstring::SpanBuffer out(storage, sizeof(storage));
+    out.push_escaped("abc\"defgh");
+    EXPECT_EQ(out.view(), "");
+    EXPECT_TRUE(out.overflowed());
+    out.push_escaped("a\"b");
+    EXPECT_EQ(out.view(), "a\\\"b");
+
+    char slot[12];
+    smallstring::SpanBuffer full(slot, sizeof(slot));
+    smallstring::JsonWriter json(full);
+    json.begin_object();
+    json.key("k");
+    json.value("x\ty\tz");
+    EXPECT_EQ(full.view(), R"({"k":)");
+    EXPECT_TRUE(full.overflowed());
+}
+
+TEST(smallstring_span_buffer_test, truncate_policy_fills_up) {
+    char storage[8];
+    smallstring::SpanBuffer<smallstring::TruncateOverflow> out(
+        storage, sizeof(storage));
+    out.push("hello");
+    out.push(std::string_view("world"));
+    EXPECT_EQ(out.view(), "hellowor");
+    EXPECT_TRUE(out.overflowed());
+
+    out.clear();
+    out.push("abc");
+    out.push("literal");
+    EXPECT_EQ(out.view(), "abcliter");
+    EXPECT_TRUE(out.overflowed());
+}
+
+TEST(smallstring_span_buffer_test, flush_policy_drains_and_resets) {
+    char storage[16];
+    std::string sink;
+    smallstring::SpanBuffer out(
+        storage, sizeof(storage),
+        smallstring::FlushOverflow(
+            [&](std::string_view bytes) { sink.append(bytes); }));
+
+    std::string expected;
+    for (int i = 0; i < 100; i++) {
+        out.push(i);
+        out.push(",");
+        expected += std::to_string(i) + ",";
+    }
+    const std::string large(40, 'L');
+    out.push(large);
+    out.push("end");
+    out.push("a literal longer than the span");
+    out.flush();
+    expected += large + "end" + "a literal longer than the span";
+    EXPECT_EQ(sink, expected);
+    EXPECT_FALSE(out.overflowed());
+}
+
+TEST(smallstring_span_buffer_test, json_writer_over_span) {
+    char storage[128];
+    smallstring::SpanBuffer out(storage, sizeof(storage));
+    smallstring::JsonWriter json(out);
+    json.begin_object();
+    json.key("id");
+    json.value(7);
+    json.key("name");
+    json.value("a\"b");
+    json.end_object();
+    EXPECT_EQ(out.view(), R"({"id":7,"name":"a\"b"})");
+}
@@ -0,0 +1,74 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <limits>
+#include <smallstring/smallstring.hpp>
+#include <smallstring/static_buffer.hpp>
+#include <stdexcept>
+#include <string>
+
+#if defined(SMALLSTRING_HAS_CONSTEXPR_PUSH)
+
+namespace {
+
+constexpr auto heartbeat =
+    smallstring::make_static_buffer<64>("8=FIX.4.4|35=0|34=", 1234, "|");
+static_assert(heartbeat.view() == "8=FIX.4.4|35=0|34=1234|");
+
+constexpr auto extremes = [] {
+    smallstring::StaticBuffer<96> buffer;
+    buffer.push(std::numeric_limits<std::int64_t>::min());
+    buffer.push(" ");
+    buffer.push(std::numeric_limits<std::uint64_t>::max());
+    buffer.push(std::string_view(" 0 "));
+    buffer.push(0);
+    buffer.push_padded(-42, 6);
+    buffer.push_hex(std::uint16_t(0xbeef));
+    return buffer;
+}();
+static_assert(extremes.view() == "-9223372036854775808 18446744073709551615"
+                                 " 0 0-00042beef");
+
+} // namespace
+
+TEST(smallstring_static_buffer_test, constexpr_messages_are_constants) {
+    static_assert(heartbeat.length() == 23);
+    EXPECT_EQ(heartbeat.view(), "8=FIX.4.4|35=0|34=1234|");
+    smallstring::Buffer<> buf;
+    buf.push(heartbeat.view());
+    buf.push(7);
+    EXPECT_EQ(buf.view(), "8=FIX.4.4|35=0|34=1234|7");
+}
+
+#endif
+
+TEST(smallstring_static_buffer_test, matches_buffer_output_at_runtime) {
+    smallstring::StaticBuffer<128> fixed;
+    smallstring::Buffer<> heap;
+    const auto both = [&](const auto& value) {
+        fixed.push(value);
+        heap.push(value);
+    };
+    both("id=");
+    both(-17);
+    both(std::string(" name="));
+    both(std::string_view("x"));
+    both(std::numeric_limits<std::uint32_t>::max());
+    both(static_cast<short>(-5));
+    fixed.push_padded(7, 3, ' ');
+    heap.push_padded(7, 3, ' ');
+    fixed.push(1.5);
+    heap.push(1.5);
+    EXPECT_EQ(fixed.view(), heap.view());
+    EXPECT_EQ(fixed.remaining(), 128 - fixed.length());
+    fixed.clear();
+    EXPECT_EQ(fixed.view(), "");
+}
+
+TEST(smallstring_static_buffer_test, overflow_throws) {
+    smallstring::StaticBuffer<4> buffer;
+    buffer.push("abc");
+    EXPECT_THROW(buffer.push(12), std::length_error);
+    EXPECT_EQ(buffer.view(), "abc");
+    buffer.push("d");
+    EXPECT_EQ(buffer.view(), "abcd");
+}
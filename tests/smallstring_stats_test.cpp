@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <smallstring/stats.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+using StatsBuffer =
+    smallstring::Buffer<std::allocator<char>, smallstring::DoublingGrowth,
+                        smallstring::VectorStorage<>,
+                        smallstring::BufferStats>;
+
+SMALLSTRING_STATS_TAG(StatsTestSite, "stats-test");
+using SiteBuffer =
+    smallstring::Buffer<std::allocator<char>, smallstring::DoublingGrowth,
+                        smallstring::VectorStorage<>,
+                        smallstring::SiteStats<StatsTestSite>>;
+
+TEST(smallstring_stats_test, disabled_stats_cost_nothing) {
+    struct Layout {
+        std::size_t begin, end;
+        smallstring::VectorStorage<> storage;
+    };
+    EXPECT_EQ(sizeof(smallstring::Buffer<>), sizeof(Layout));
+}
+
+TEST(smallstring_stats_test, buffer_stats_count_growth_and_messages) {
+    StatsBuffer buffer(16);
+    buffer.push(std::string(10, 'a'));
+    buffer.push(std::string(10, 'b')); // 16 -> 32, copies 10 bytes
+    EXPECT_EQ(buffer.stats().resizes, 1UL);
+    EXPECT_EQ(buffer.stats().bytes_copied, 10UL);
+    EXPECT_EQ(buffer.stats().peak_length, 20UL);
+
+    buffer.pop(15);
+    buffer.push(std::string(20, 'c')); // compacts 5 bytes, no resize
+    EXPECT_EQ(buffer.stats().resizes, 1UL);
+    EXPECT_EQ(buffer.stats().bytes_copied, 15UL);
+
+    buffer.clear();
+    buffer.clear(); // empty: not a message
+    for (int i = 0; i < 98; i++) {
+        buffer.push("abc");
+        buffer.clear();
+    }
+    const auto& stats = buffer.stats();
+    EXPECT_EQ(stats.messages, 99UL);
+    EXPECT_EQ(stats.size_histogram[2], 98UL); // 3 bytes
+    EXPECT_EQ(stats.size_histogram[5], 1UL);  // 25 bytes
+    EXPECT_EQ(stats.percentile(0.5), 3UL);
+    EXPECT_EQ(stats.percentile(1.0), 31UL);
+}
+
+TEST(smallstring_stats_test, site_stats_aggregate_across_threads) {
+    smallstring::StatsRegistry::instance().reset();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([] {
+            for (int i = 0; i < 100; i++) {
+                SiteBuffer buffer(8);
+                buffer.push("0123456789");
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    const auto counters = smallstring::SiteStats<StatsTestSite>::counters();
+    EXPECT_EQ(counters.messages, 400UL);
+    EXPECT_EQ(counters.resizes, 400UL);
+    EXPECT_EQ(counters.peak_length, 10UL);
+    EXPECT_EQ(counters.size_histogram[4], 400UL);
+
+    bool found = false;
+    smallstring::StatsRegistry::instance().for_each(
+        [&](const char* name, const smallstring::StatsCounters& c) {
+            if (std::string(name) == "stats-test") {
+                found = true;
+                EXPECT_EQ(c.messages, 400UL);
+            }
+        });
+    EXPECT_TRUE(found);
+}